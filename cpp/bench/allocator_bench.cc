@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "wasmdemo/allocator.h"
+
+#include "benchmark.h"
+
+namespace {
+
+// The pattern of the JS wrappers: allocate a buffer for a key, pass it to one
+// call, then free it. "libc" is what the malloc export did before it pooled.
+void libcMallocFree(BenchmarkState& state, int size) {
+  while (state.keepRunning()) {
+    void* const ptr = malloc(static_cast<size_t>(size));
+    doNotOptimize(ptr);
+    free(ptr);
+  }
+  state.setItemsPerIteration(1);
+}
+
+void pooledMallocFree(BenchmarkState& state, int size) {
+  while (state.keepRunning()) {
+    void* const ptr = my_wasm_malloc(size);
+    doNotOptimize(ptr);
+    my_wasm_free(ptr);
+  }
+  state.setItemsPerIteration(1);
+}
+
+void arenaAllocReset(BenchmarkState& state, int size) {
+  Arena* const arena = arenaCreate(64 * 1024);
+  while (state.keepRunning()) {
+    doNotOptimize(arenaAlloc(arena, size));
+    arenaReset(arena);
+  }
+  arenaDestroy(arena);
+  state.setItemsPerIteration(1);
+}
+
+} // namespace
+
+void registerAllocatorBenchmarks(BenchmarkRegistry& registry) {
+  // A typical document key, and a small batch of them.
+  for (int size : {100, 4000}) {
+    const std::string suffix = "/" + std::to_string(size);
+    registry.add("libc_malloc_free" + suffix, [size](BenchmarkState& state) {
+      libcMallocFree(state, size);
+    });
+    registry.add("pooled_malloc_free" + suffix, [size](BenchmarkState& state) {
+      pooledMallocFree(state, size);
+    });
+    registry.add("arena_alloc_reset" + suffix, [size](BenchmarkState& state) {
+      arenaAllocReset(state, size);
+    });
+  }
+}
@@ -0,0 +1,76 @@
+#include <string>
+#include <vector>
+
+#include "wasmdemo/base64.h"
+
+#include "benchmark.h"
+
+namespace {
+
+std::string randomBytes(size_t length) {
+  std::string bytes(length, '\0');
+  uint32_t state = 12345;
+  for (char& c : bytes) {
+    state = state * 1103515245 + 12345;
+    c = static_cast<char>(state >> 24);
+  }
+  return bytes;
+}
+
+void base64Encode(BenchmarkState& state, size_t length) {
+  const std::string bytes = randomBytes(length);
+  while (state.keepRunning()) {
+    const std::string encoded = base64_encode(bytes);
+    doNotOptimize(encoded.data()[0]);
+  }
+  state.setBytesPerIteration(length);
+}
+
+void base64EncodeInto(BenchmarkState& state, size_t length) {
+  const std::string bytes = randomBytes(length);
+  std::vector<char> encoded(base64_encoded_size(length));
+  const std::span<const unsigned char> input(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size());
+  while (state.keepRunning()) {
+    doNotOptimize(base64_encode_into(input, encoded));
+  }
+  state.setBytesPerIteration(length);
+}
+
+void base64Decode(BenchmarkState& state, size_t length) {
+  const std::string encoded = base64_encode(randomBytes(length));
+  while (state.keepRunning()) {
+    const std::string decoded = base64_decode(encoded);
+    doNotOptimize(decoded.data()[0]);
+  }
+  state.setBytesPerIteration(length);
+}
+
+void base64DecodeInto(BenchmarkState& state, size_t length) {
+  const std::string encoded = base64_encode(randomBytes(length));
+  std::vector<unsigned char> decoded(base64_decoded_size(encoded));
+  while (state.keepRunning()) {
+    doNotOptimize(base64_decode_into(encoded, decoded.data()));
+  }
+  state.setBytesPerIteration(length);
+}
+
+} // namespace
+
+void registerBase64Benchmarks(BenchmarkRegistry& registry) {
+  // The decoded sizes are those of the bitmaps of the golden test filters.
+  for (size_t length : {3u, 1199u, 11983u, 119815u}) {
+    const std::string suffix = "/" + std::to_string(length);
+    registry.add("base64_encode" + suffix, [length](BenchmarkState& state) {
+      base64Encode(state, length);
+    });
+    registry.add("base64_encode_into" + suffix, [length](BenchmarkState& state) {
+      base64EncodeInto(state, length);
+    });
+    registry.add("base64_decode" + suffix, [length](BenchmarkState& state) {
+      base64Decode(state, length);
+    });
+    registry.add("base64_decode_into" + suffix, [length](BenchmarkState& state) {
+      base64DecodeInto(state, length);
+    });
+  }
+}
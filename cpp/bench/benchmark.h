@@ -0,0 +1,103 @@
+#ifndef WASMDEMO_CPP_BENCH_BENCHMARK_H_
+#define WASMDEMO_CPP_BENCH_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A minimal benchmark harness, modelled on Google Benchmark, that builds for
+// wasm32-wasi as well as natively, so that the same benchmarks can be compared
+// between the two and between releases. A benchmark is a function that does
+// its setup, then runs the code being measured in a
+// `while (state.keepRunning())` loop; the harness picks the iteration count.
+
+class BenchmarkState {
+ public:
+  explicit BenchmarkState(uint64_t iterations) : _iterations(iterations), _remaining(iterations) {
+  }
+
+  // Returns true until the loop body has run iterations() times. The timer
+  // starts at the first call and stops at the last.
+  bool keepRunning() {
+    if (_remaining == _iterations) {
+      _startTime = std::chrono::steady_clock::now();
+    }
+    if (_remaining == 0) {
+      _elapsed = std::chrono::steady_clock::now() - _startTime;
+      return false;
+    }
+    _remaining--;
+    return true;
+  }
+
+  uint64_t iterations() const {
+    return _iterations;
+  }
+
+  // The number of bytes or items processed by each iteration, for reporting
+  // throughput; zero if not applicable.
+  void setBytesPerIteration(uint64_t bytes) {
+    _bytesPerIteration = bytes;
+  }
+  void setItemsPerIteration(uint64_t items) {
+    _itemsPerIteration = items;
+  }
+
+  uint64_t bytesPerIteration() const {
+    return _bytesPerIteration;
+  }
+  uint64_t itemsPerIteration() const {
+    return _itemsPerIteration;
+  }
+
+  std::chrono::steady_clock::duration elapsed() const {
+    return _elapsed;
+  }
+
+ private:
+  uint64_t _iterations;
+  uint64_t _remaining;
+  uint64_t _bytesPerIteration = 0;
+  uint64_t _itemsPerIteration = 0;
+  std::chrono::steady_clock::time_point _startTime;
+  std::chrono::steady_clock::duration _elapsed {};
+};
+
+// Prevents the compiler from optimizing away the computation of `value`.
+template <typename T>
+void doNotOptimize(const T& value) {
+  const volatile T sink = value;
+  (void) sink;
+}
+
+struct Benchmark {
+  std::string name;
+  std::function<void(BenchmarkState&)> function;
+};
+
+// The benchmarks, in the order that they are run. Each *_bench.cc file
+// registers its benchmarks with a function that is called from main().
+class BenchmarkRegistry {
+ public:
+  void add(std::string name, std::function<void(BenchmarkState&)> function) {
+    _benchmarks.push_back(Benchmark {std::move(name), std::move(function)});
+  }
+
+  const std::vector<Benchmark>& benchmarks() const {
+    return _benchmarks;
+  }
+
+ private:
+  std::vector<Benchmark> _benchmarks;
+};
+
+void registerMd5Benchmarks(BenchmarkRegistry& registry);
+void registerXxh3Benchmarks(BenchmarkRegistry& registry);
+void registerBase64Benchmarks(BenchmarkRegistry& registry);
+void registerBloomBenchmarks(BenchmarkRegistry& registry);
+void registerAllocatorBenchmarks(BenchmarkRegistry& registry);
+
+#endif // WASMDEMO_CPP_BENCH_BENCHMARK_H_
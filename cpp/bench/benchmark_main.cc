@@ -0,0 +1,221 @@
+// Runs the wasmdemo_lib benchmarks and writes the results to stdout, as JSON by
+// default. The JSON has the same shape as Google Benchmark's
+// --benchmark_format=json output, so results from different releases can be
+// compared with its tools/compare.py.
+//
+// Usage: wasmdemo_bench [--filter=<substring>] [--min-time=<seconds>]
+//                       [--format=json|console]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+#include "benchmark.h"
+
+namespace {
+
+struct Options {
+  std::string filter;
+  double minTimeSeconds = 0.5;
+  bool json = true;
+};
+
+struct Result {
+  std::string name;
+  uint64_t iterations;
+  double nanosPerIteration;
+  double bytesPerSecond;
+  double itemsPerSecond;
+};
+
+bool parseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg(argv[i]);
+    if (arg.starts_with("--filter=")) {
+      options.filter = arg.substr(9);
+    } else if (arg.starts_with("--min-time=")) {
+      options.minTimeSeconds = std::atof(std::string(arg.substr(11)).c_str());
+      if (!(options.minTimeSeconds > 0)) {
+        std::fprintf(stderr, "ERROR: invalid --min-time: %s\n", argv[i]);
+        return false;
+      }
+    } else if (arg == "--format=json") {
+      options.json = true;
+    } else if (arg == "--format=console") {
+      options.json = false;
+    } else {
+      std::fprintf(stderr, "ERROR: unknown argument: %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+double toSeconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+// Runs the benchmark with more and more iterations until one run takes at
+// least the minimum time, and returns the results of that run.
+Result runBenchmark(const Benchmark& benchmark, const Options& options) {
+  const uint64_t maxIterations = 1000000000;
+  uint64_t iterations = 1;
+  while (true) {
+    BenchmarkState state(iterations);
+    benchmark.function(state);
+    const double seconds = toSeconds(state.elapsed());
+
+    if (seconds >= options.minTimeSeconds || iterations >= maxIterations) {
+      return Result {
+        benchmark.name,
+        iterations,
+        seconds * 1e9 / static_cast<double>(iterations),
+        static_cast<double>(state.bytesPerIteration() * iterations) / seconds,
+        static_cast<double>(state.itemsPerIteration() * iterations) / seconds,
+      };
+    }
+
+    // Aim 40% past the minimum time, growing by at least 2x and at most 10x.
+    const double multiplier = seconds <= 0 ? 10 : options.minTimeSeconds * 1.4 / seconds;
+    const double nextIterations = static_cast<double>(iterations) * std::min(10.0, std::max(2.0, multiplier));
+    iterations = std::min(maxIterations, static_cast<uint64_t>(nextIterations));
+  }
+}
+
+std::string jsonString(std::string_view value) {
+  std::string quoted = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+const char* targetName() {
+#if defined(__wasm32__)
+  return "wasm32";
+#elif defined(__x86_64__)
+  return "x86_64";
+#elif defined(__aarch64__)
+  return "aarch64";
+#else
+  return "unknown";
+#endif
+}
+
+// The vector extensions that the library was compiled with, which select its
+// SIMD code paths.
+const char* simdName() {
+#if defined(__wasm_simd128__)
+  return "simd128";
+#elif defined(__AVX512F__)
+  return "avx512f";
+#elif defined(__AVX2__)
+  return "avx2";
+#elif defined(__SSE2__)
+  return "sse2";
+#elif defined(__ARM_NEON)
+  return "neon";
+#else
+  return "none";
+#endif
+}
+
+void printJsonHeader(const char* executable) {
+  char date[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+  std::printf("{\n");
+  std::printf("  \"context\": {\n");
+  std::printf("    \"date\": %s,\n", jsonString(date).c_str());
+  std::printf("    \"executable\": %s,\n", jsonString(executable).c_str());
+  std::printf("    \"target\": %s,\n", jsonString(targetName()).c_str());
+  std::printf("    \"simd\": %s,\n", jsonString(simdName()).c_str());
+  std::printf("    \"compiler\": %s,\n", jsonString(__VERSION__).c_str());
+#ifdef NDEBUG
+  std::printf("    \"build_type\": \"release\"\n");
+#else
+  std::printf("    \"build_type\": \"debug\"\n");
+#endif
+  std::printf("  },\n");
+  std::printf("  \"benchmarks\": [");
+}
+
+void printJsonResult(const Result& result, bool first) {
+  std::printf("%s\n    {\n", first ? "" : ",");
+  std::printf("      \"name\": %s,\n", jsonString(result.name).c_str());
+  std::printf("      \"run_name\": %s,\n", jsonString(result.name).c_str());
+  std::printf("      \"run_type\": \"iteration\",\n");
+  std::printf("      \"iterations\": %llu,\n", static_cast<unsigned long long>(result.iterations));
+  // WASI has no portable CPU time clock, so cpu_time repeats real_time, which
+  // tools/compare.py requires.
+  std::printf("      \"real_time\": %.3f,\n", result.nanosPerIteration);
+  std::printf("      \"cpu_time\": %.3f,\n", result.nanosPerIteration);
+  std::printf("      \"time_unit\": \"ns\"");
+  if (result.bytesPerSecond > 0) {
+    std::printf(",\n      \"bytes_per_second\": %.1f", result.bytesPerSecond);
+  }
+  if (result.itemsPerSecond > 0) {
+    std::printf(",\n      \"items_per_second\": %.1f", result.itemsPerSecond);
+  }
+  std::printf("\n    }");
+  std::fflush(stdout);
+}
+
+void printConsoleResult(const Result& result) {
+  std::printf("%-48s %14.1f ns %12llu", result.name.c_str(), result.nanosPerIteration,
+              static_cast<unsigned long long>(result.iterations));
+  if (result.bytesPerSecond > 0) {
+    std::printf(" %10.1f MB/s", result.bytesPerSecond / 1e6);
+  }
+  if (result.itemsPerSecond > 0) {
+    std::printf(" %10.3f M items/s", result.itemsPerSecond / 1e6);
+  }
+  std::printf("\n");
+  std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    std::fprintf(stderr, "Usage: %s [--filter=<substring>] [--min-time=<seconds>] [--format=json|console]\n", argv[0]);
+    return 2;
+  }
+
+  BenchmarkRegistry registry;
+  registerMd5Benchmarks(registry);
+  registerXxh3Benchmarks(registry);
+  registerBase64Benchmarks(registry);
+  registerBloomBenchmarks(registry);
+  registerAllocatorBenchmarks(registry);
+
+  if (options.json) {
+    printJsonHeader(argv[0]);
+  }
+  bool first = true;
+  for (const Benchmark& benchmark : registry.benchmarks()) {
+    if (benchmark.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    const Result result = runBenchmark(benchmark, options);
+    if (options.json) {
+      printJsonResult(result, first);
+    } else {
+      printConsoleResult(result);
+    }
+    first = false;
+  }
+  if (options.json) {
+    std::printf("\n  ]\n}\n");
+  }
+  return 0;
+}
@@ -0,0 +1,438 @@
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "wasmdemo/base64.h"
+#include "wasmdemo/bloom.h"
+#include "wasmdemo/bloom_cache.h"
+
+#include "benchmark.h"
+#include "random_sequence.h"
+
+namespace {
+
+// The parameters of the golden test filters with a false positive rate of
+// 0.0001, which are named after the number of keys that they contain.
+struct FilterSpec {
+  uint32_t keyCount;
+  uint32_t size;
+  uint32_t hashCount;
+};
+
+const FilterSpec FILTER_SPECS[] = {
+  {1, 23, 16},
+  {500, 9587, 13},
+  {5000, 95857, 13},
+  {50000, 958519, 13},
+};
+
+// A filter of the size of the largest golden test filter, but holding only a
+// few keys, which BloomFilter stores as a SparseBitmap.
+const FilterSpec SPARSE_FILTER_SPEC = {20, 958519, 13};
+
+// The number of distinct keys that the probe benchmarks cycle through.
+const uint32_t PROBE_KEY_COUNT = 1024;
+
+// The number of keys that the parallel probe benchmarks test per call: enough
+// for every thread to get several runs of keys, like a large reconciliation.
+const uint32_t PARALLEL_PROBE_KEY_COUNT = 65536;
+
+// The bitmap length and hash count of the large filter benchmarks: 16 MB is
+// far beyond the L1 and L2 caches, so nearly every bit that they test misses
+// those, although it may still fit in a large last-level cache (e.g. the
+// 105 MB L3 that these benchmarks were first measured on).
+const uint32_t LARGE_BITMAP_LENGTH = 16 << 20;
+const uint32_t LARGE_HASH_COUNT = 13;
+
+// The number of hashes that the large filter benchmarks probe per iteration.
+const uint32_t LARGE_PROBE_HASH_COUNT = 65536;
+
+std::string memberKey(uint32_t i) {
+  return "projects/project-1/databases/database-1/documents/coll/doc" + std::to_string(i);
+}
+
+std::string nonMemberKey(uint32_t i) {
+  return "projects/project-1/databases/database-1/documents/coll/missing" + std::to_string(i);
+}
+
+// The prefix of the keys of a deeply nested collection, which is longer than
+// one 64-byte MD5 block.
+const std::string LONG_KEY_PREFIX =
+    "projects/my-cool-project/databases/(default)/documents/collectionA/docA/collectionB/docB/collectionC/doc";
+
+// A bitmap holding the member keys of a filter, set the same way as the
+// backend does.
+struct FilterBitmap {
+  std::vector<uint8_t> bytes;
+  uint32_t padding;
+  uint32_t hashCount;
+
+  explicit FilterBitmap(const FilterSpec& spec) : hashCount(spec.hashCount) {
+    BloomFilterBuilder builder(spec.size, spec.hashCount);
+    for (uint32_t i = 0; i < spec.keyCount; i++) {
+      const std::string key = memberKey(i);
+      builder.insert(key.data(), static_cast<uint32_t>(key.length()));
+    }
+    bytes.assign(builder.bitmap(), builder.bitmap() + builder.bitmapLength());
+    padding = builder.padding();
+  }
+
+  BloomFilter* newFilter() const {
+    return newBloomFilter(reinterpret_cast<const int8_t*>(bytes.data()),
+                          static_cast<int32_t>(bytes.size()),
+                          static_cast<int32_t>(padding),
+                          static_cast<int32_t>(hashCount));
+  }
+};
+
+void bloomNew(BenchmarkState& state, const FilterSpec& spec) {
+  const FilterBitmap bitmap(spec);
+  while (state.keepRunning()) {
+    BloomFilter* filter = bitmap.newFilter();
+    doNotOptimize(filter);
+    deleteBloomFilter(filter);
+  }
+  state.setBytesPerIteration(bitmap.bytes.size());
+}
+
+void bloomNewFromBase64(BenchmarkState& state, const FilterSpec& spec) {
+  const FilterBitmap bitmap(spec);
+  const std::string encoded = base64_encode(bitmap.bytes.data(), bitmap.bytes.size());
+  while (state.keepRunning()) {
+    BloomFilter* filter = newBloomFilterFromBase64(encoded.data(),
+                                                   static_cast<int32_t>(encoded.length()),
+                                                   static_cast<int32_t>(bitmap.padding),
+                                                   static_cast<int32_t>(bitmap.hashCount));
+    doNotOptimize(filter);
+    deleteBloomFilter(filter);
+  }
+  state.setBytesPerIteration(encoded.length());
+}
+
+// Gets a filter that is already cached from a BloomFilterCache, given its
+// bitmap (if not `base64`) or its base64 text (if `base64`), which is what
+// receiving the same filter again costs instead of bloomNew() or
+// bloomNewFromBase64().
+void bloomCacheHit(BenchmarkState& state, const FilterSpec& spec, bool base64) {
+  const FilterBitmap bitmap(spec);
+  const std::string encoded = base64_encode(bitmap.bytes.data(), bitmap.bytes.size());
+  const auto padding = static_cast<int32_t>(bitmap.padding);
+  const auto hashCount = static_cast<int32_t>(bitmap.hashCount);
+  const auto insert = [&](BloomFilterCache* cache) {
+    if (base64) {
+      return bloomFilterCacheInsertBase64(cache, encoded.data(), static_cast<int32_t>(encoded.length()), padding, hashCount);
+    }
+    return bloomFilterCacheInsert(cache, reinterpret_cast<const int8_t*>(bitmap.bytes.data()),
+                                  static_cast<int32_t>(bitmap.bytes.size()), padding, hashCount);
+  };
+
+  BloomFilterCache cache(bitmap.bytes.size() * 2);
+  cache.release(insert(&cache));
+  while (state.keepRunning()) {
+    BloomFilter* filter = insert(&cache);
+    doNotOptimize(filter);
+    bloomFilterCacheRelease(&cache, filter);
+  }
+  state.setBytesPerIteration(base64 ? encoded.length() : bitmap.bytes.size());
+}
+
+// Probes one key per iteration, cycling through PROBE_KEY_COUNT keys that were
+// (if `members`) or were not inserted into the filter.
+void bloomMightContain(BenchmarkState& state, const FilterSpec& spec, bool members) {
+  const FilterBitmap bitmap(spec);
+  const std::unique_ptr<BloomFilter, void (*)(BloomFilter*)> filter(bitmap.newFilter(), deleteBloomFilter);
+  std::vector<std::string> keys;
+  for (uint32_t i = 0; i < PROBE_KEY_COUNT; i++) {
+    keys.push_back(members ? memberKey(i % spec.keyCount) : nonMemberKey(i));
+  }
+
+  uint32_t i = 0;
+  while (state.keepRunning()) {
+    const std::string& key = keys[i++ % PROBE_KEY_COUNT];
+    doNotOptimize(mightContain(filter.get(), key.data(), static_cast<int32_t>(key.length())));
+  }
+  state.setItemsPerIteration(1);
+}
+
+// Probes PROBE_KEY_COUNT keys, alternately members and non-members, with one
+// mightContainBatch() call per iteration.
+void bloomMightContainBatch(BenchmarkState& state, const FilterSpec& spec) {
+  const FilterBitmap bitmap(spec);
+  const std::unique_ptr<BloomFilter, void (*)(BloomFilter*)> filter(bitmap.newFilter(), deleteBloomFilter);
+  std::string keys;
+  std::vector<int32_t> offsets {0};
+  for (uint32_t i = 0; i < PROBE_KEY_COUNT; i++) {
+    keys += i % 2 == 0 ? memberKey(i / 2 % spec.keyCount) : nonMemberKey(i);
+    offsets.push_back(static_cast<int32_t>(keys.length()));
+  }
+
+  std::vector<uint8_t> results(PROBE_KEY_COUNT / 8);
+  while (state.keepRunning()) {
+    doNotOptimize(mightContainBatch(filter.get(), keys.data(), offsets.data(),
+                                    static_cast<int32_t>(PROBE_KEY_COUNT), results.data()));
+  }
+  state.setItemsPerIteration(PROBE_KEY_COUNT);
+}
+
+// Probes PROBE_KEY_COUNT keys with LONG_KEY_PREFIX one at a time, passing the
+// prefix as a KeyPrefix if `withPrefix`, or as part of the whole key if not.
+void bloomMightContainLongKey(BenchmarkState& state, const FilterSpec& spec, bool withPrefix) {
+  const FilterBitmap bitmap(spec);
+  const std::unique_ptr<BloomFilter, void (*)(BloomFilter*)> filter(bitmap.newFilter(), deleteBloomFilter);
+  const std::unique_ptr<KeyPrefix, void (*)(KeyPrefix*)> prefix(
+      newKeyPrefix(LONG_KEY_PREFIX.data(), static_cast<int32_t>(LONG_KEY_PREFIX.length())), deleteKeyPrefix);
+  std::vector<std::string> keys;
+  for (uint32_t i = 0; i < PROBE_KEY_COUNT; i++) {
+    keys.push_back((withPrefix ? "" : LONG_KEY_PREFIX) + std::to_string(i));
+  }
+
+  uint32_t i = 0;
+  while (state.keepRunning()) {
+    const std::string& key = keys[i++ % PROBE_KEY_COUNT];
+    if (withPrefix) {
+      doNotOptimize(mightContainWithPrefix(filter.get(), prefix.get(), key.data(), static_cast<int32_t>(key.length())));
+    } else {
+      doNotOptimize(mightContain(filter.get(), key.data(), static_cast<int32_t>(key.length())));
+    }
+  }
+  state.setItemsPerIteration(1);
+}
+
+// Like bloomMightContainLongKey(), but probes all of the keys with one
+// mightContainBatch() or mightContainBatchWithPrefix() call per iteration.
+void bloomMightContainBatchLongKey(BenchmarkState& state, const FilterSpec& spec, bool withPrefix) {
+  const FilterBitmap bitmap(spec);
+  const std::unique_ptr<BloomFilter, void (*)(BloomFilter*)> filter(bitmap.newFilter(), deleteBloomFilter);
+  const std::unique_ptr<KeyPrefix, void (*)(KeyPrefix*)> prefix(
+      newKeyPrefix(LONG_KEY_PREFIX.data(), static_cast<int32_t>(LONG_KEY_PREFIX.length())), deleteKeyPrefix);
+  std::string keys;
+  std::vector<int32_t> offsets {0};
+  for (uint32_t i = 0; i < PROBE_KEY_COUNT; i++) {
+    keys += (withPrefix ? "" : LONG_KEY_PREFIX) + std::to_string(i);
+    offsets.push_back(static_cast<int32_t>(keys.length()));
+  }
+
+  std::vector<uint8_t> results(PROBE_KEY_COUNT / 8);
+  while (state.keepRunning()) {
+    if (withPrefix) {
+      doNotOptimize(mightContainBatchWithPrefix(filter.get(), prefix.get(), keys.data(), offsets.data(),
+                                                static_cast<int32_t>(PROBE_KEY_COUNT), results.data()));
+    } else {
+      doNotOptimize(mightContainBatch(filter.get(), keys.data(), offsets.data(),
+                                      static_cast<int32_t>(PROBE_KEY_COUNT), results.data()));
+    }
+  }
+  state.setItemsPerIteration(PROBE_KEY_COUNT);
+}
+
+// Probes PARALLEL_PROBE_KEY_COUNT keys, alternately members and non-members,
+// with one mightContainBatchParallel() call on `threadCount` threads per
+// iteration, for measuring how probing scales with the number of threads.
+void bloomMightContainBatchParallel(BenchmarkState& state, const FilterSpec& spec, int32_t threadCount) {
+  const FilterBitmap bitmap(spec);
+  const std::unique_ptr<BloomFilter, void (*)(BloomFilter*)> filter(bitmap.newFilter(), deleteBloomFilter);
+  std::string keys;
+  std::vector<int32_t> offsets {0};
+  for (uint32_t i = 0; i < PARALLEL_PROBE_KEY_COUNT; i++) {
+    keys += i % 2 == 0 ? memberKey(i / 2 % spec.keyCount) : nonMemberKey(i);
+    offsets.push_back(static_cast<int32_t>(keys.length()));
+  }
+
+  std::vector<uint8_t> results(PARALLEL_PROBE_KEY_COUNT / 8);
+  while (state.keepRunning()) {
+    doNotOptimize(mightContainBatchParallel(filter.get(), keys.data(), offsets.data(),
+                                            static_cast<int32_t>(PARALLEL_PROBE_KEY_COUNT), results.data(),
+                                            threadCount));
+  }
+  state.setItemsPerIteration(PARALLEL_PROBE_KEY_COUNT);
+}
+
+// Computes the estimated false positive rate of a filter, which counts its set
+// bits, for comparing the cost of that check with the cost of probing.
+void bloomEstimatedFalsePositiveRate(BenchmarkState& state, const FilterSpec& spec) {
+  const FilterBitmap bitmap(spec);
+  const std::unique_ptr<BloomFilter, void (*)(BloomFilter*)> filter(bitmap.newFilter(), deleteBloomFilter);
+  while (state.keepRunning()) {
+    doNotOptimize(bloomFilterEstimatedFalsePositiveRate(filter.get()));
+  }
+  state.setBytesPerIteration(bitmap.bytes.size());
+}
+
+// Inserts the member keys of a filter with one insertBatch() call per
+// iteration. Inserting a key again sets the same bits, so every iteration does
+// the same work.
+void bloomBuilderInsertBatch(BenchmarkState& state, const FilterSpec& spec) {
+  std::string keys;
+  std::vector<uint32_t> offsets {0};
+  for (uint32_t i = 0; i < spec.keyCount; i++) {
+    keys += memberKey(i);
+    offsets.push_back(static_cast<uint32_t>(keys.length()));
+  }
+
+  BloomFilterBuilder builder(spec.size, spec.hashCount);
+  while (state.keepRunning()) {
+    builder.insertBatch(keys.data(), offsets.data(), spec.keyCount);
+  }
+  doNotOptimize(builder.bitmap()[0]);
+  state.setItemsPerIteration(spec.keyCount);
+}
+
+// Probes LARGE_PROBE_HASH_COUNT random hashes against a LARGE_BITMAP_LENGTH
+// bitmap with 7 of every 8 bits set, so that a probe tests about 6.6 bits, each
+// in its own cache line, before it finds a clear one. If not `pipelined`, the
+// hashes are tested one at a time, and each of those misses waits for the one
+// before it to decide whether to go on; if `pipelined`, they are tested with
+// mightContainHashes(), which prefetches the bits of several hashes at once.
+void bloomMightContainHashesLarge(BenchmarkState& state, bool pipelined) {
+  uint64_t randomState = 1;
+  std::vector<uint8_t> bytes(BloomFilter::storageSizeFor(LARGE_BITMAP_LENGTH));
+  for (uint8_t& byte : bytes) {
+    byte = static_cast<uint8_t>(nextRandom(randomState) | nextRandom(randomState) | nextRandom(randomState));
+  }
+  BloomFilter filter(bytes.data(), LARGE_BITMAP_LENGTH, 0, LARGE_HASH_COUNT, BloomFilter::BitmapOwnership::Borrow);
+  std::vector<uint8_t> digests(LARGE_PROBE_HASH_COUNT * 16);
+  for (uint8_t& byte : digests) {
+    byte = static_cast<uint8_t>(nextRandom(randomState));
+  }
+
+  std::vector<uint8_t> results(LARGE_PROBE_HASH_COUNT / 8);
+  while (state.keepRunning()) {
+    if (pipelined) {
+      doNotOptimize(filter.mightContainHashes(digests.data(), LARGE_PROBE_HASH_COUNT, results.data()));
+      continue;
+    }
+    uint32_t positiveCount = 0;
+    for (uint32_t i = 0; i < LARGE_PROBE_HASH_COUNT; i++) {
+      positiveCount += filter.mightContainHash(digests.data() + i * 16) ? 1 : 0;
+    }
+    doNotOptimize(positiveCount);
+  }
+  state.setItemsPerIteration(LARGE_PROBE_HASH_COUNT);
+}
+
+// Probes PROBE_KEY_COUNT keys, alternately members and non-members, of a
+// BlockedBloomFilter that hashes keys with `keyHash`, one at a time if not
+// `batch`, or with one mightContainBatch() call per iteration if `batch`.
+void blockedBloomMightContain(BenchmarkState& state, const FilterSpec& spec, KeyHash keyHash, bool batch) {
+  const std::unique_ptr<BlockedBloomFilter> filter(BlockedBloomFilter::create(BlockedBloomFilter::blockCountFor(spec.keyCount, 0.0001), keyHash));
+  for (uint32_t i = 0; i < spec.keyCount; i++) {
+    const std::string key = memberKey(i);
+    filter->insert(key.data(), static_cast<uint32_t>(key.length()));
+  }
+  std::vector<std::string> keys;
+  std::string packedKeys;
+  std::vector<uint32_t> offsets {0};
+  for (uint32_t i = 0; i < PROBE_KEY_COUNT; i++) {
+    keys.push_back(i % 2 == 0 ? memberKey(i / 2 % spec.keyCount) : nonMemberKey(i));
+    packedKeys += keys.back();
+    offsets.push_back(static_cast<uint32_t>(packedKeys.length()));
+  }
+
+  if (batch) {
+    std::vector<uint8_t> results(PROBE_KEY_COUNT / 8);
+    while (state.keepRunning()) {
+      doNotOptimize(filter->mightContainBatch(packedKeys.data(), offsets.data(), PROBE_KEY_COUNT, results.data()));
+    }
+    state.setItemsPerIteration(PROBE_KEY_COUNT);
+    return;
+  }
+
+  uint32_t i = 0;
+  while (state.keepRunning()) {
+    const std::string& key = keys[i++ % PROBE_KEY_COUNT];
+    doNotOptimize(filter->mightContain(key.data(), static_cast<uint32_t>(key.length())));
+  }
+  state.setItemsPerIteration(1);
+}
+
+} // namespace
+
+void registerBloomBenchmarks(BenchmarkRegistry& registry) {
+  for (const FilterSpec& spec : FILTER_SPECS) {
+    const std::string suffix = "/" + std::to_string(spec.keyCount);
+    registry.add("bloom_new" + suffix, [spec](BenchmarkState& state) {
+      bloomNew(state, spec);
+    });
+    registry.add("bloom_new_from_base64" + suffix, [spec](BenchmarkState& state) {
+      bloomNewFromBase64(state, spec);
+    });
+    registry.add("bloom_cache_hit" + suffix, [spec](BenchmarkState& state) {
+      bloomCacheHit(state, spec, false);
+    });
+    registry.add("bloom_cache_hit_base64" + suffix, [spec](BenchmarkState& state) {
+      bloomCacheHit(state, spec, true);
+    });
+    registry.add("bloom_might_contain_hit" + suffix, [spec](BenchmarkState& state) {
+      bloomMightContain(state, spec, true);
+    });
+    registry.add("bloom_might_contain_miss" + suffix, [spec](BenchmarkState& state) {
+      bloomMightContain(state, spec, false);
+    });
+    registry.add("bloom_might_contain_batch" + suffix, [spec](BenchmarkState& state) {
+      bloomMightContainBatch(state, spec);
+    });
+    registry.add("bloom_estimated_false_positive_rate" + suffix, [spec](BenchmarkState& state) {
+      bloomEstimatedFalsePositiveRate(state, spec);
+    });
+    registry.add("bloom_builder_insert_batch" + suffix, [spec](BenchmarkState& state) {
+      bloomBuilderInsertBatch(state, spec);
+    });
+  }
+
+  const std::string sparseSuffix = "_sparse/" + std::to_string(SPARSE_FILTER_SPEC.keyCount);
+  registry.add("bloom_new" + sparseSuffix, [](BenchmarkState& state) {
+    bloomNew(state, SPARSE_FILTER_SPEC);
+  });
+  registry.add("bloom_new_from_base64" + sparseSuffix, [](BenchmarkState& state) {
+    bloomNewFromBase64(state, SPARSE_FILTER_SPEC);
+  });
+  registry.add("bloom_cache_hit" + sparseSuffix, [](BenchmarkState& state) {
+    bloomCacheHit(state, SPARSE_FILTER_SPEC, false);
+  });
+  registry.add("bloom_might_contain_hit" + sparseSuffix, [](BenchmarkState& state) {
+    bloomMightContain(state, SPARSE_FILTER_SPEC, true);
+  });
+  registry.add("bloom_might_contain_miss" + sparseSuffix, [](BenchmarkState& state) {
+    bloomMightContain(state, SPARSE_FILTER_SPEC, false);
+  });
+
+  // The cost of hashing long keys does not depend on the filter size, so only
+  // measure it with the largest filter.
+  const FilterSpec& largestSpec = FILTER_SPECS[std::size(FILTER_SPECS) - 1];
+  const std::string suffix = "/" + std::to_string(largestSpec.keyCount);
+  for (bool withPrefix : {false, true}) {
+    const std::string variant = withPrefix ? "_with_prefix" : "_long_key";
+    registry.add("bloom_might_contain" + variant + suffix, [largestSpec, withPrefix](BenchmarkState& state) {
+      bloomMightContainLongKey(state, largestSpec, withPrefix);
+    });
+    registry.add("bloom_might_contain_batch" + variant + suffix, [largestSpec, withPrefix](BenchmarkState& state) {
+      bloomMightContainBatchLongKey(state, largestSpec, withPrefix);
+    });
+  }
+
+  for (int32_t threadCount : {1, 2, 4, 8}) {
+    registry.add("bloom_might_contain_batch_parallel" + suffix + "/" + std::to_string(threadCount),
+                 [largestSpec, threadCount](BenchmarkState& state) {
+                   bloomMightContainBatchParallel(state, largestSpec, threadCount);
+                 });
+  }
+
+  const std::string largeSuffix = "/" + std::to_string(LARGE_BITMAP_LENGTH >> 20) + "mb";
+  registry.add("bloom_might_contain_hash_large" + largeSuffix, [](BenchmarkState& state) {
+    bloomMightContainHashesLarge(state, false);
+  });
+  registry.add("bloom_might_contain_hashes_large" + largeSuffix, [](BenchmarkState& state) {
+    bloomMightContainHashesLarge(state, true);
+  });
+
+  for (KeyHash keyHash : {KeyHash::MD5, KeyHash::XXH3_128}) {
+    const std::string hashName = keyHash == KeyHash::MD5 ? "/md5" : "/xxh3";
+    registry.add("blocked_bloom_might_contain" + hashName + suffix, [largestSpec, keyHash](BenchmarkState& state) {
+      blockedBloomMightContain(state, largestSpec, keyHash, false);
+    });
+    registry.add("blocked_bloom_might_contain_batch" + hashName + suffix, [largestSpec, keyHash](BenchmarkState& state) {
+      blockedBloomMightContain(state, largestSpec, keyHash, true);
+    });
+  }
+}
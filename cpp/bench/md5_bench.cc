@@ -0,0 +1,59 @@
+#include <string>
+#include <vector>
+
+#include "wasmdemo/hash.h"
+
+#include "benchmark.h"
+
+namespace {
+
+void md5(BenchmarkState& state, unsigned int length) {
+  // One byte more than is hashed, so that data() is not null for length 0.
+  const std::vector<unsigned char> data(length + 1, 'x');
+  unsigned char result[16];
+  while (state.keepRunning()) {
+    MD5_CTX context;
+    MD5_Init(&context);
+    MD5_Update(&context, data.data(), length);
+    MD5_Final(result, &context);
+    doNotOptimize(result[0]);
+  }
+  state.setBytesPerIteration(length);
+}
+
+// Hashes `count` keys of the given length with one MD5_Multi() call.
+void md5Multi(BenchmarkState& state, unsigned int length, unsigned int count) {
+  std::vector<std::string> keys;
+  std::vector<const void*> keyData;
+  const std::vector<unsigned int> keyLengths(count, length);
+  for (unsigned int i = 0; i < count; i++) {
+    keys.push_back(std::string(length, static_cast<char>('a' + i % 26)));
+  }
+  for (const std::string& key : keys) {
+    keyData.push_back(key.data());
+  }
+
+  std::vector<unsigned char> results(count * 16);
+  while (state.keepRunning()) {
+    MD5_Multi(keyData.data(), keyLengths.data(), count, results.data());
+    doNotOptimize(results[0]);
+  }
+  state.setBytesPerIteration(static_cast<uint64_t>(length) * count);
+  state.setItemsPerIteration(count);
+}
+
+} // namespace
+
+void registerMd5Benchmarks(BenchmarkRegistry& registry) {
+  for (unsigned int length : {0u, 16u, 55u, 64u, 100u, 1024u, 16384u}) {
+    registry.add("md5/" + std::to_string(length), [length](BenchmarkState& state) {
+      md5(state, length);
+    });
+  }
+  // Batches of 64 keys, the chunk size of BloomFilter::mightContainBatch().
+  for (unsigned int length : {16u, 64u, 100u}) {
+    registry.add("md5_multi/" + std::to_string(length) + "/64", [length](BenchmarkState& state) {
+      md5Multi(state, length, 64);
+    });
+  }
+}
@@ -0,0 +1,27 @@
+#include <string>
+#include <vector>
+
+#include "wasmdemo/xxh3.h"
+
+#include "benchmark.h"
+
+namespace {
+
+void xxh3(BenchmarkState& state, unsigned int length) {
+  const std::vector<unsigned char> data(length, 'x');
+  while (state.keepRunning()) {
+    doNotOptimize(xxh3Hash128(data.data(), length).low64);
+  }
+  state.setBytesPerIteration(length);
+}
+
+} // namespace
+
+void registerXxh3Benchmarks(BenchmarkRegistry& registry) {
+  // The same lengths as the md5 benchmarks, for comparison.
+  for (unsigned int length : {0u, 16u, 55u, 64u, 100u, 1024u, 16384u}) {
+    registry.add("xxh3/" + std::to_string(length), [length](BenchmarkState& state) {
+      xxh3(state, length);
+    });
+  }
+}
@@ -0,0 +1,118 @@
+#ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_ALLOCATOR_H_
+#define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#if WASMDEMO_THREADS
+#include <mutex>
+#endif
+
+#include "wasmdemo/macros.h"
+
+// A bump allocator for scratch memory that is only needed until the next
+// reset(), such as the keys that JS copies into linear memory for one call. An
+// allocation is a pointer increment; reset() frees everything at once but keeps
+// the blocks, so a long-lived arena stops calling malloc() once it has grown to
+// the largest amount of scratch memory that it is used for. Not thread-safe.
+class Arena {
+ public:
+  // The alignment of every allocation.
+  static const uint32_t ALIGNMENT = 16;
+
+  // Creates an arena that allocates memory from malloc() in blocks of
+  // `blockSize` bytes, or larger for allocations that do not fit in one block.
+  explicit Arena(uint32_t blockSize);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena();
+
+  // Returns `size` bytes that stay valid until reset() or the arena's deletion,
+  // or null if out of memory.
+  void* alloc(uint32_t size);
+
+  // Frees every allocation, keeping the blocks for reuse.
+  void reset();
+
+  // The total size of the blocks, which only grows.
+  size_t capacity() const;
+
+ private:
+  struct Block;
+
+  uint32_t _blockSize;
+  Block* _firstBlock = nullptr;
+  // The block that alloc() allocates from, and the offset of its free space;
+  // the blocks after it are empty.
+  Block* _currentBlock = nullptr;
+  uint32_t _offset = 0;
+};
+
+// A general-purpose allocator for the small buffers that JS allocates and frees
+// all the time. Sizes up to MAX_CLASS_SIZE are rounded up to a power of two and
+// served from a free list per size, which is refilled a slab at a time, so that
+// churn neither calls malloc() nor fragments the heap. Freed blocks are kept for
+// reuse rather than returned to malloc(). Larger sizes go straight to malloc().
+class SizeClassPool {
+ public:
+  static const uint32_t MIN_CLASS_SIZE = 16;
+  static const uint32_t MAX_CLASS_SIZE = 4096;
+
+  SizeClassPool() = default;
+
+  SizeClassPool(const SizeClassPool&) = delete;
+  SizeClassPool& operator=(const SizeClassPool&) = delete;
+
+  // Frees the slabs, and with them every block that was allocated from them.
+  ~SizeClassPool();
+
+  // Returns `size` bytes aligned like malloc(), or null if out of memory.
+  void* alloc(size_t size);
+
+  // Frees a block returned by alloc(); does nothing if `ptr` is null.
+  void free(void* ptr);
+
+ private:
+  // 16, 32, ... MAX_CLASS_SIZE.
+  static const uint32_t CLASS_COUNT = 9;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  struct Slab {
+    Slab* next;
+  };
+
+  FreeBlock* _freeLists[CLASS_COUNT] = {};
+  Slab* _slabs = nullptr;
+#if WASMDEMO_THREADS
+  std::mutex _mutex;
+#endif
+
+  bool refill(uint32_t sizeClass);
+};
+
+WASM_EXPORT("malloc")
+void* my_wasm_malloc(int size);
+
+WASM_EXPORT("free")
+void my_wasm_free(void* ptr);
+
+// Creates an Arena for per-request scratch memory; see Arena.
+WASM_EXPORT("arenaCreate")
+Arena* arenaCreate(int32_t blockSize);
+
+// Returns null if out of memory.
+WASM_EXPORT("arenaAlloc")
+void* arenaAlloc(Arena* arena, int32_t size);
+
+WASM_EXPORT("arenaReset")
+void arenaReset(Arena* arena);
+
+WASM_EXPORT("arenaDestroy")
+void arenaDestroy(Arena* arena);
+
+#endif // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_ALLOCATOR_H_
@@ -6,18 +6,30 @@
 #ifndef BASE64_H_C0CE2A47_D10E_42C9_A27C_C883944E704A
 #define BASE64_H_C0CE2A47_D10E_42C9_A27C_C883944E704A
 
+#include <cstddef>
+
+// WASMDEMO_MINIMAL builds (see the WASMDEMO_WASM32_MINIMAL cmake option) leave
+// out the std::string functions, so that nothing depends on std::string.
+#if !WASMDEMO_MINIMAL
 #include <string>
+#endif  // !WASMDEMO_MINIMAL
 
 #if __cplusplus >= 201703L
 #include <string_view>
 #endif  // __cplusplus >= 201703L
 
+#if __cplusplus >= 202002L
+#include <span>
+#endif  // __cplusplus >= 202002L
+
+#if !WASMDEMO_MINIMAL
 std::string base64_encode     (std::string const& s, bool url = false);
 std::string base64_encode_pem (std::string const& s);
 std::string base64_encode_mime(std::string const& s);
 
 std::string base64_decode(std::string const& s, bool remove_linebreaks = false);
 std::string base64_encode(unsigned char const*, size_t len, bool url = false);
+#endif  // !WASMDEMO_MINIMAL
 
 #if __cplusplus >= 201703L
 //
@@ -25,11 +37,71 @@ std::string base64_encode(unsigned char const*, size_t len, bool url = false);
 // Requires C++17
 // Provided by Yannic Bonenberger (https://github.com/Yannic)
 //
+#if !WASMDEMO_MINIMAL
 std::string base64_encode     (std::string_view s, bool url = false);
 std::string base64_encode_pem (std::string_view s);
 std::string base64_encode_mime(std::string_view s);
 
 std::string base64_decode(std::string_view s, bool remove_linebreaks = false);
+#endif  // !WASMDEMO_MINIMAL
+
+//
+// Allocation-free interface that reports the exact output size up front and
+// encodes or decodes into a caller-provided buffer. The std::string functions
+// above are implemented on top of it.
+//
+// base64_encoded_size() is the number of characters that encoding len bytes
+// produces; a non-zero line_length inserts a '\n' after every line_length
+// characters (except at the end), as for PEM (64) and MIME (76).
+// base64_decoded_size() is the number of bytes that decoding s produces (or an
+// upper bound, if padding appears before the last group of 4 characters).
+//
+// The std::span variants write nothing and return 0 if dest is smaller than
+// that size; the pointer variant trusts that dest is large enough. All of them
+// return the number of bytes actually written.
+//
+size_t base64_encoded_size(size_t len, size_t line_length = 0);
+size_t base64_decoded_size(std::string_view s, bool remove_linebreaks = false);
+
+size_t base64_decode_into (std::string_view s, unsigned char* dest);
 #endif  // __cplusplus >= 201703L
 
+#if __cplusplus >= 202002L
+size_t base64_encode_into(std::span<const unsigned char> bytes, std::span<char> dest,
+                          bool url = false, size_t line_length = 0);
+size_t base64_decode_into(std::string_view s, std::span<unsigned char> dest,
+                          bool remove_linebreaks = false);
+
+//
+// Decodes base64 text that arrives in pieces (e.g. from the network), without
+// buffering more than the 3 characters of an incomplete group between calls.
+// Feeding all of the pieces to update() and then calling finish() produces the
+// same bytes as base64_decode() of the concatenated text.
+//
+class Base64Decoder {
+ public:
+  explicit Base64Decoder(bool remove_linebreaks = false);
+
+  // The most bytes that update() can write for a piece of the given length.
+  [[nodiscard]] size_t max_update_size(size_t len) const;
+
+  // Decodes every complete group of 4 characters, writing at most
+  // max_update_size(s.length()) bytes to dest, and returns the number of bytes
+  // written.
+  size_t update(std::string_view s, unsigned char* dest);
+
+  // Decodes the final, incomplete group (if any), writing at most 2 bytes to
+  // dest, and returns the number of bytes written. The decoder can then be
+  // reused for new input.
+  size_t finish(unsigned char* dest);
+
+ private:
+  size_t update_without_linebreaks(std::string_view s, unsigned char* dest);
+
+  char _pending[4];
+  size_t _pending_size;
+  bool _remove_linebreaks;
+};
+#endif  // __cplusplus >= 202002L
+
 #endif /* BASE64_H_C0CE2A47_D10E_42C9_A27C_C883944E704A */
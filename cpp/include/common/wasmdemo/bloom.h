@@ -1,33 +1,528 @@
 #ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_BLOOM_H_
 #define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_BLOOM_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if !WASMDEMO_MINIMAL
+#include <string>
+#endif
+
+#include "wasmdemo/fastmod.h"
+#include "wasmdemo/hash.h"
 #include "wasmdemo/macros.h"
+#include "wasmdemo/sparse_bitmap.h"
+
+// WASMDEMO_MINIMAL builds (see the WASMDEMO_WASM32_MINIMAL cmake option) leave
+// out the thread pool, along with the parallel probes.
+#if !WASMDEMO_MINIMAL
+#include "wasmdemo/thread_pool.h"
+#endif
+
+// The hash function that a filter derives the bits of a key from. The value of
+// each algorithm is also its id in the header of a serialized
+// BlockedBloomFilter.
+enum class KeyHash : uint8_t {
+  // MD5, as required by the Firestore bloom filter specification.
+  MD5 = 0,
+  // XXH3_128bits() (see xxh3.h), which is several times faster than MD5, but
+  // may only be used for filters whose format we own.
+  XXH3_128 = 1,
+};
+
+// A prefix that many keys share, such as the path of a collection's documents,
+// along with the MD5 state after hashing it. Probing an MD5 filter with a key
+// given as this prefix and a suffix only hashes the suffix (and the prefix's
+// last partial 64-byte block), rather than the whole key. Other hashes cannot
+// resume from a midstate, so they hash the prefix along with every suffix.
+class KeyPrefix {
+ public:
+  KeyPrefix(const char* prefix, uint32_t prefixLength);
+
+  uint32_t length() const {
+    return static_cast<uint32_t>(_prefix.size());
+  }
+
+  std::string_view prefix() const {
+    return std::string_view(_prefix.data(), _prefix.size());
+  }
+
+  const MD5_CTX& md5Context() const {
+    return _md5Context;
+  }
+
+ private:
+  MD5_CTX _md5Context;
+  std::vector<char> _prefix;
+};
 
 class BloomFilter {
  public:
-  BloomFilter(const uint8_t* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount);
+  // How a BloomFilter manages the memory of the bitmap that it is given.
+  enum class BitmapOwnership {
+    // The filter takes ownership of the bitmap, which must have been allocated
+    // with malloc() (e.g. by the allocBloomFilterBitmap export, but not by the
+    // malloc export, which pools its blocks) with room for storageSizeFor()
+    // bytes, and frees it when the filter is deleted.
+    Adopt,
+    // The filter uses the bitmap in place; the caller must keep it alive and
+    // unmodified until the filter is deleted, and then free it. It must be
+    // 8-byte aligned, with room for storageSizeFor() bytes.
+    Borrow,
+  };
+
+  // How a BloomFilter maps the double hashing values h(i) = h1 + i * h2 of a
+  // key onto bit indexes. The value of each mapping is also its id in
+  // BloomFilterBuilder::toJson().
+  enum class IndexMapping {
+    // h(i) % size, as required by the Firestore bloom filter specification.
+    Modulo = 0,
+    // (upper 32 bits of h(i)) * size / 2^32, Lemire's multiply-shift range
+    // reduction. It needs no division at all, but sets different bits than
+    // Modulo, so it may only be used for filters whose format we own.
+    MultiplyShift = 1,
+  };
+
+  // Creates a filter with its own copy of the given bitmap, which is a
+  // SparseBitmap if that is much smaller.
+  BloomFilter(const uint8_t* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount,
+              IndexMapping indexMapping = IndexMapping::Modulo, KeyHash keyHash = KeyHash::MD5);
+
+  // Creates a filter that uses the given bitmap without copying it. An adopted
+  // bitmap is converted to a SparseBitmap, and freed right away, if that is
+  // much smaller.
+  BloomFilter(uint8_t* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount, BitmapOwnership ownership,
+              IndexMapping indexMapping = IndexMapping::Modulo, KeyHash keyHash = KeyHash::MD5);
+
+  BloomFilter(const BloomFilter&) = delete;
+  BloomFilter& operator=(const BloomFilter&) = delete;
 
   ~BloomFilter();
 
+  // The size of the storage for a bitmap of `bitmapLength` bytes, which the
+  // filter reads a 64-bit word at a time: the length rounded up to whole words.
+  // The contents of the bytes past the bitmap do not matter, although the
+  // filter does load them; the allocating functions zero them.
+  static uint32_t storageSizeFor(uint32_t bitmapLength);
+
   bool mightContain(const char* value, uint32_t valueLength);
 
+  // Tests `keyCount` keys packed back-to-back in `keys`, where key `i` spans
+  // `keys[offsets[i]]` up to (but not including) `keys[offsets[i + 1]]`, so
+  // `offsets` must have `keyCount + 1` entries. The result for key `i` is
+  // written to bit `i % 8` of `results[i / 8]`, which must have room for
+  // `(keyCount + 7) / 8` bytes. Returns the number of keys that might be
+  // contained in this filter.
+  uint32_t mightContainBatch(const char* keys, const uint32_t* offsets, uint32_t keyCount, uint8_t* results);
+
+#if !WASMDEMO_MINIMAL
+  // Like mightContainBatch(), but splits the keys into runs of whole results
+  // bytes and probes the runs on the threads of `pool`. Probing only reads the
+  // filter, so any number of threads may probe one filter at the same time.
+  uint32_t mightContainBatch(const char* keys, const uint32_t* offsets, uint32_t keyCount, uint8_t* results, ThreadPool& pool);
+#endif
+
+  // Like mightContain(), for the key that is `prefix` followed by `suffix`.
+  bool mightContain(const KeyPrefix& prefix, const char* suffix, uint32_t suffixLength);
+
+  // Like mightContainBatch(), for the keys that are `prefix` followed by each
+  // of the suffixes packed in `suffixes`.
+  uint32_t mightContainBatch(const KeyPrefix& prefix, const char* suffixes, const uint32_t* offsets, uint32_t keyCount, uint8_t* results);
+
+  // Tests a key given its 16-byte hash with this filter's KeyHash, e.g. as
+  // computed by MD5_Multi() for an MD5 filter. Unlike mightContain(), this
+  // cannot tell that the key is empty.
+  bool mightContainHash(const uint8_t* digest);
+
+  // Tests `count` 16-byte hashes, stored back-to-back in `digests`, writing the
+  // results and returning the number of positives like mightContainBatch().
+  // Like mightContainBatch(), it prefetches the bits of the hashes a few ahead
+  // of the one that it tests if the bitmap is too large to stay in cache.
+  uint32_t mightContainHashes(const uint8_t* digests, uint32_t count, uint8_t* results);
+
+  // Whether the filter stores its bitmap as a SparseBitmap.
+  bool isSparse() const {
+    return _sparseBitmap != nullptr;
+  }
+
+  // The number of bytes of memory that the bitmap takes up.
+  size_t memoryUsage() const;
+
+  // The number of bits that are set in the bitmap, not counting the padding.
+  uint64_t setBitCount() const;
+
+  // Estimates how many distinct keys were inserted from the fraction of bits
+  // that are set: -(size / hashCount) * ln(1 - setBitCount / size). Returns
+  // infinity if every bit is set.
+  double estimatedItemCount() const;
+
+  // The probability that a key that was not inserted is a false positive,
+  // (setBitCount / size)^hashCount, as measured by how full the filter is
+  // rather than predicted from how many keys it was built for.
+  double estimatedFalsePositiveRate() const;
+
  private:
   uint64_t _size;
+  // At least storageSizeFor() bytes, and 8-byte aligned; null if sparse.
   uint8_t* _bitmap;
+  SparseBitmap* _sparseBitmap = nullptr;
   uint32_t _hashCount;
-  uint64_t getBitIndex(uint64_t num1, uint64_t num2, uint64_t index);
+  bool _ownsBitmap;
+  IndexMapping _indexMapping;
+  KeyHash _keyHash;
+  // Reduces modulo _size without dividing; only valid when _size is non-zero.
+  FastModulo _sizeModulo;
+
+  // Tests a hash against `filter`; see probeHashFor().
+  typedef bool (*ProbeHash)(const BloomFilter& filter, const uint8_t* digest);
+  // The probe kernel for this filter's index mapping and hash count, which is
+  // chosen once, when the filter is created.
+  ProbeHash _probeHash;
+
+  // Prefetches the bits of a hash in `filter`; see prefetchHash().
+  typedef void (*PrefetchHash)(const BloomFilter& filter, const uint8_t* digest);
+  // The prefetch for this filter's index mapping, chosen along with _probeHash.
+  PrefetchHash _prefetchHash;
+
+  // Returns the probe kernel for the index mapping and hash count: one that is
+  // specialized for the hash count, if it is one of the common ones, or a loop
+  // over the filter's hash count otherwise.
+  static ProbeHash probeHashFor(IndexMapping indexMapping, uint32_t hashCount);
+
+  // The probe kernel for FIXED_HASH_COUNT hashes, or for the filter's own hash
+  // count if FIXED_HASH_COUNT is 0.
+  template <IndexMapping INDEX_MAPPING, uint32_t FIXED_HASH_COUNT>
+  static bool probeHash(const BloomFilter& filter, const uint8_t* digest);
+
+  uint64_t loadWord(uint64_t wordIndex) const;
+
+  bool isBitSet(uint64_t n) const;
 
-  bool isBitSet(uint64_t n);
+  // Prefetches the bits that mightContainHash() tests for the hash, so that a
+  // batch can wait on the cache misses of several keys at once instead of one
+  // after the other. Does nothing unless the bitmap is dense and large.
+  void prefetchHash(const uint8_t* digest) const {
+    _prefetchHash(*this, digest);
+  }
+
+  // The implementation of prefetchHash() for an index mapping.
+  template <IndexMapping INDEX_MAPPING>
+  static void prefetchKernel(const BloomFilter& filter, const uint8_t* digest);
+};
+
+// Builds the bitmap of a BloomFilter by inserting keys, for generating filters
+// locally (e.g. in tests, or in place of the backend) rather than receiving
+// them. A key sets the same bits that BloomFilter::mightContain() tests, so a
+// builder with the backend's size and hash count reproduces its bitmaps.
+class BloomFilterBuilder {
+ public:
+  // Creates a builder for an empty filter of `bitCount` bits that sets
+  // `hashCount` bits per key.
+  BloomFilterBuilder(uint32_t bitCount, uint32_t hashCount,
+                     BloomFilter::IndexMapping indexMapping = BloomFilter::IndexMapping::Modulo,
+                     KeyHash keyHash = KeyHash::MD5);
+
+  BloomFilterBuilder(const BloomFilterBuilder&) = delete;
+  BloomFilterBuilder& operator=(const BloomFilterBuilder&) = delete;
+
+  // Returns the optimal number of bits for a filter with the given false
+  // positive rate after inserting `expectedItemCount` keys, at most INT32_MAX.
+  static uint32_t bitCountFor(uint64_t expectedItemCount, double falsePositiveRate);
+
+  // The largest hash count that hashCountFor() returns. A sparser filter would
+  // gain next to nothing from more hashes, and every key costs one bit test
+  // per hash.
+  static constexpr uint32_t MAX_HASH_COUNT = 64;
+
+  // Returns the number of bits per key that minimizes the false positive rate
+  // of a filter of `bitCount` bits after inserting `expectedItemCount` keys, at
+  // most MAX_HASH_COUNT.
+  static uint32_t hashCountFor(uint32_t bitCount, uint64_t expectedItemCount);
+
+  uint32_t bitCount() const {
+    return _size;
+  }
+
+  uint32_t hashCount() const {
+    return _hashCount;
+  }
+
+  // The bitmap, in the byte order of the golden test data and of the bitmap
+  // that BloomFilter takes, followed by zeros up to
+  // BloomFilter::storageSizeFor(bitmapLength()) bytes, so that a BloomFilter
+  // can borrow it.
+  const uint8_t* bitmap() const {
+    return _bitmap.data();
+  }
+
+  uint32_t bitmapLength() const {
+    return static_cast<uint32_t>((static_cast<uint64_t>(_size) + 7) / 8);
+  }
+
+  // The number of unused bits at the end of the bitmap.
+  uint32_t padding() const {
+    return bitmapLength() * 8 - _size;
+  }
+
+  // Does nothing for the empty key, which a BloomFilter never contains.
+  void insert(const char* value, uint32_t valueLength);
+
+  // Inserts `keyCount` keys packed as for BloomFilter::mightContainBatch(),
+  // hashing them a chunk at a time.
+  void insertBatch(const char* keys, const uint32_t* offsets, uint32_t keyCount);
+
+  // Sets every bit that is set in `other`, so that the filter contains the keys
+  // of both. Returns false, leaving this builder unchanged, if the filters
+  // differ in size, hash count, index mapping or key hash.
+  bool unionWith(const BloomFilterBuilder& other);
+
+  // Clears every bit that is not set in `other`. A key of both filters is still
+  // contained, but so may be more keys than if only those keys had been
+  // inserted. Returns false under the same conditions as unionWith().
+  bool intersectWith(const BloomFilterBuilder& other);
+
+  // Creates a BloomFilter with a copy of the bitmap.
+  BloomFilter* build() const;
+
+  // Returns the filter in the JSON form of the golden test data, e.g.
+  // `{ "bits": { "bitmap": "RswZ", "padding": 1 }, "hashCount": 16 }`. A key
+  // hash or index mapping other than the Firestore ones (MD5 and Modulo) is
+  // recorded by its id, as in `..., "hashCount": 7, "keyHash": 1 }`, since
+  // the bitmap means nothing without it.
+#if !WASMDEMO_MINIMAL
+  std::string toJson() const;
+#endif
+
+ private:
+  std::vector<uint8_t> _bitmap;
+  uint32_t _size;
+  uint32_t _hashCount;
+  BloomFilter::IndexMapping _indexMapping;
+  KeyHash _keyHash;
+  // Reduces modulo _size without dividing; only valid when _size is non-zero.
+  FastModulo _sizeModulo;
+
+  void insertHash(const uint8_t* digest);
+
+  bool isCompatibleWith(const BloomFilterBuilder& other) const;
+};
+
+// A "split block" bloom filter, as used by Apache Parquet, for filters whose
+// format we control. The bitmap is an array of 256-bit blocks; a key selects
+// one block with the upper half of the first 64 bits of its hash, and sets
+// one bit in each of the block's eight 32-bit words, chosen by multiplying the
+// lower half by a different odd salt per word. Since all of a key's bits live
+// in one block, a probe touches a single cache line and is one SIMD compare,
+// instead of up to hashCount cache misses with BloomFilter.
+class BlockedBloomFilter {
+ public:
+  // The size of one block, in bytes.
+  static constexpr uint32_t BLOCK_SIZE = 32;
+
+  // The size of the header that serialize() writes before the blocks: the
+  // magic "WBBF", a format version, a hash algorithm, two reserved bytes, and
+  // the block count as a little-endian uint32.
+  static constexpr uint32_t HEADER_SIZE = 12;
+
+  ~BlockedBloomFilter();
+
+  BlockedBloomFilter(const BlockedBloomFilter&) = delete;
+  BlockedBloomFilter& operator=(const BlockedBloomFilter&) = delete;
+
+  // Returns the smallest number of blocks for which the expected false positive
+  // rate after inserting `expectedItemCount` keys is at most the given rate.
+  static uint32_t blockCountFor(uint64_t expectedItemCount, double falsePositiveRate);
+
+  // Creates an empty filter with the given number of blocks, which hashes keys
+  // with `keyHash`, or returns nullptr if the blocks cannot be allocated.
+  static BlockedBloomFilter* create(uint32_t blockCount, KeyHash keyHash = KeyHash::MD5);
+
+  // Creates a filter from the output of serialize(), or returns nullptr if the
+  // data is malformed, names an unknown hash algorithm, or has more blocks than
+  // can be allocated.
+  static BlockedBloomFilter* deserialize(const uint8_t* data, uint32_t length);
+
+  KeyHash keyHash() const {
+    return _keyHash;
+  }
+
+  uint32_t serializedSize() const;
+
+  // Writes serializedSize() bytes to `dest`.
+  void serialize(uint8_t* dest) const;
+
+  void insert(const char* value, uint32_t valueLength);
+
+  bool mightContain(const char* value, uint32_t valueLength) const;
+
+  // Same as BloomFilter::mightContainBatch().
+  uint32_t mightContainBatch(const char* keys, const uint32_t* offsets, uint32_t keyCount, uint8_t* results) const;
+
+ private:
+  uint32_t _blockCount;
+  uint32_t* _blocks;
+  KeyHash _keyHash;
+
+  // Takes ownership of `blocks`, which must come from aligned_alloc().
+  BlockedBloomFilter(uint32_t blockCount, uint32_t* blocks, KeyHash keyHash);
+
+  void insertHash(const uint8_t* digest);
+
+  bool mightContainHash(const uint8_t* digest) const;
+
+  uint32_t* blockForHash(uint64_t hash) const;
 };
 
 
 WASM_EXPORT("newBloomFilter")
 BloomFilter* newBloomFilter(const int8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount);
 
+// Allocates a buffer for a bitmap of the given length, padded to whole 64-bit
+// words, into which the caller can write the bitmap before passing it to
+// newBloomFilterAdoptingBitmap. Only the padding is initialized, to zeros.
+// Returns null if there is not enough memory.
+WASM_EXPORT("allocBloomFilterBitmap")
+uint8_t* allocBloomFilterBitmap(int32_t bitmapLength);
+
+// Creates a filter that takes ownership of the given bitmap instead of copying
+// it; see BloomFilter::BitmapOwnership::Adopt. The bitmap is freed by
+// deleteBloomFilter and must not be freed by the caller.
+WASM_EXPORT("newBloomFilterAdoptingBitmap")
+BloomFilter* newBloomFilterAdoptingBitmap(uint8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount);
+
+// Like newBloomFilterAdoptingBitmap, for a filter with the given
+// BloomFilter::IndexMapping and KeyHash values rather than the Firestore ones;
+// aborts if either is unknown.
+WASM_EXPORT("newBloomFilterAdoptingBitmapWithOptions")
+BloomFilter* newBloomFilterAdoptingBitmapWithOptions(uint8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount,
+                                                     int32_t indexMapping, int32_t keyHash);
+
+// Creates a filter that uses the given bitmap in place instead of copying it;
+// see BloomFilter::BitmapOwnership::Borrow, including its size and alignment
+// requirements. The caller must free the bitmap, but only after calling
+// deleteBloomFilter.
+WASM_EXPORT("newBloomFilterBorrowingBitmap")
+BloomFilter* newBloomFilterBorrowingBitmap(const uint8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount);
+
+// Creates a filter from the base64-encoded bitmap, decoding it directly into
+// the filter's own bitmap storage. Returns null if that storage cannot be
+// allocated.
+WASM_EXPORT("newBloomFilterFromBase64")
+BloomFilter* newBloomFilterFromBase64(const char* base64Bitmap, int32_t base64BitmapLength, int32_t padding, int32_t hashCount);
+
+// Like newBloomFilterFromBase64, with the options of
+// newBloomFilterAdoptingBitmapWithOptions.
+WASM_EXPORT("newBloomFilterFromBase64WithOptions")
+BloomFilter* newBloomFilterFromBase64WithOptions(const char* base64Bitmap, int32_t base64BitmapLength, int32_t padding, int32_t hashCount,
+                                                 int32_t indexMapping, int32_t keyHash);
+
 WASM_EXPORT("deleteBloomFilter")
 void deleteBloomFilter(BloomFilter* instance);
 
+// Creates a builder for an empty filter sized for `expectedItemCount` keys at
+// the given false positive rate, which must be between 0 and 1 (exclusive);
+// see BloomFilterBuilder.
+WASM_EXPORT("newBloomFilterBuilder")
+BloomFilterBuilder* newBloomFilterBuilder(int32_t expectedItemCount, double falsePositiveRate);
+
+// Like newBloomFilterBuilder, with the options of
+// newBloomFilterAdoptingBitmapWithOptions.
+WASM_EXPORT("newBloomFilterBuilderWithOptions")
+BloomFilterBuilder* newBloomFilterBuilderWithOptions(int32_t expectedItemCount, double falsePositiveRate,
+                                                     int32_t indexMapping, int32_t keyHash);
+
+WASM_EXPORT("deleteBloomFilterBuilder")
+void deleteBloomFilterBuilder(BloomFilterBuilder* instance);
+
+WASM_EXPORT("bloomFilterBuilderInsert")
+void bloomFilterBuilderInsert(BloomFilterBuilder* builder, const char* value, int32_t valueLength);
+
+// Inserts keys packed as for mightContainBatch.
+WASM_EXPORT("bloomFilterBuilderInsertBatch")
+void bloomFilterBuilderInsertBatch(BloomFilterBuilder* builder, const char* keys, const int32_t* offsets, int32_t keyCount);
+
+// Returns false if the builders' filters are not compatible.
+WASM_EXPORT("bloomFilterBuilderUnion")
+bool bloomFilterBuilderUnion(BloomFilterBuilder* builder, const BloomFilterBuilder* other);
+
+// Returns false if the builders' filters are not compatible.
+WASM_EXPORT("bloomFilterBuilderIntersect")
+bool bloomFilterBuilderIntersect(BloomFilterBuilder* builder, const BloomFilterBuilder* other);
+
+// Creates a filter from the builder's current bitmap, which the builder keeps.
+WASM_EXPORT("bloomFilterBuilderBuild")
+BloomFilter* bloomFilterBuilderBuild(const BloomFilterBuilder* builder);
+
+// The bitmap changes as keys are inserted, and stays valid until the builder is
+// deleted.
+WASM_EXPORT("bloomFilterBuilderBitmap")
+const uint8_t* bloomFilterBuilderBitmap(const BloomFilterBuilder* builder);
+
+WASM_EXPORT("bloomFilterBuilderBitmapLength")
+int32_t bloomFilterBuilderBitmapLength(const BloomFilterBuilder* builder);
+
+WASM_EXPORT("bloomFilterBuilderPadding")
+int32_t bloomFilterBuilderPadding(const BloomFilterBuilder* builder);
+
+WASM_EXPORT("bloomFilterBuilderHashCount")
+int32_t bloomFilterBuilderHashCount(const BloomFilterBuilder* builder);
+
 WASM_EXPORT("mightContain")
 bool mightContain(BloomFilter* filter, const char* value, int32_t valueLength);
 
+// See BloomFilter::setBitCount(); filters from the exports have fewer than
+// 2^31 bits.
+WASM_EXPORT("bloomFilterSetBitCount")
+int32_t bloomFilterSetBitCount(const BloomFilter* filter);
+
+// See BloomFilter::estimatedItemCount().
+WASM_EXPORT("bloomFilterEstimatedItemCount")
+double bloomFilterEstimatedItemCount(const BloomFilter* filter);
+
+// See BloomFilter::estimatedFalsePositiveRate(). A filter whose rate is close
+// to 1 is too full to be worth probing, since it says yes to almost anything.
+WASM_EXPORT("bloomFilterEstimatedFalsePositiveRate")
+double bloomFilterEstimatedFalsePositiveRate(const BloomFilter* filter);
+
+WASM_EXPORT("mightContainBatch")
+int32_t mightContainBatch(BloomFilter* filter, const char* keys, const int32_t* offsets, int32_t keyCount, uint8_t* results);
+
+// Like mightContainBatch, but probes the keys on `threadCount` threads (0 means
+// one per hardware thread). Without thread support, i.e. unless built with
+// WASMDEMO_THREADS, the keys are probed on the calling thread.
+#if !WASMDEMO_MINIMAL
+WASM_EXPORT("mightContainBatchParallel")
+int32_t mightContainBatchParallel(BloomFilter* filter, const char* keys, const int32_t* offsets, int32_t keyCount, uint8_t* results, int32_t threadCount);
+#endif
+
+// Hashes a prefix that many keys share once, for mightContainWithPrefix() and
+// mightContainBatchWithPrefix().
+WASM_EXPORT("newKeyPrefix")
+KeyPrefix* newKeyPrefix(const char* prefix, int32_t prefixLength);
+
+WASM_EXPORT("deleteKeyPrefix")
+void deleteKeyPrefix(KeyPrefix* instance);
+
+WASM_EXPORT("mightContainWithPrefix")
+bool mightContainWithPrefix(BloomFilter* filter, const KeyPrefix* prefix, const char* suffix, int32_t suffixLength);
+
+WASM_EXPORT("mightContainBatchWithPrefix")
+int32_t mightContainBatchWithPrefix(BloomFilter* filter, const KeyPrefix* prefix, const char* suffixes, const int32_t* offsets, int32_t keyCount, uint8_t* results);
+
+// Creates a filter from the output of BlockedBloomFilter::serialize(), or
+// returns null if the data is malformed.
+WASM_EXPORT("newBlockedBloomFilter")
+BlockedBloomFilter* newBlockedBloomFilter(const uint8_t* data, int32_t length);
+
+WASM_EXPORT("deleteBlockedBloomFilter")
+void deleteBlockedBloomFilter(BlockedBloomFilter* instance);
+
+WASM_EXPORT("blockedBloomFilterMightContain")
+bool blockedBloomFilterMightContain(BlockedBloomFilter* filter, const char* value, int32_t valueLength);
+
+WASM_EXPORT("blockedBloomFilterMightContainBatch")
+int32_t blockedBloomFilterMightContainBatch(BlockedBloomFilter* filter, const char* keys, const int32_t* offsets, int32_t keyCount, uint8_t* results);
+
 #endif  // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_BLOOM_H_
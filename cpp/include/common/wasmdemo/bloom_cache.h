@@ -0,0 +1,158 @@
+#ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_BLOOM_CACHE_H_
+#define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_BLOOM_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#if WASMDEMO_THREADS
+#include <mutex>
+#endif
+
+#include "wasmdemo/bloom.h"
+#include "wasmdemo/macros.h"
+
+// Keeps the BloomFilters that were created from recently received bitmaps, so
+// that receiving the same filter again (e.g. after a reconnect) returns the
+// existing filter instead of creating a new one.
+//
+// Filters are keyed by the XXH3-128 digest of the bitmap that they were created
+// from, along with its length, encoding, padding and hash count. Finding a
+// filter still reads that bitmap once to hash it, so the cache pays off most
+// for base64 bitmaps, which are hashed several times faster than they are
+// decoded, and for bitmaps that would be converted to a SparseBitmap; a dense
+// bitmap is copied about as fast as it is hashed.
+//
+// The filters that the cache returns are reference counted: every filter
+// returned by a lookup or insert must be passed to release() once, instead of
+// being deleted. When the filters take up more than the cache's byte budget,
+// the least recently used filters that are not referenced are deleted; filters
+// that are in use are never deleted, so they may exceed the budget.
+class BloomFilterCache {
+ public:
+  // Creates a cache whose filters take up at most about `maxBytes` bytes, as
+  // measured by BloomFilter::memoryUsage(), unless the filters in use do.
+  explicit BloomFilterCache(size_t maxBytes);
+
+  BloomFilterCache(const BloomFilterCache&) = delete;
+  BloomFilterCache& operator=(const BloomFilterCache&) = delete;
+
+  // Deletes every filter, including the ones that have not been released.
+  ~BloomFilterCache();
+
+  // Returns the cached filter for the given bitmap, padding and hash count, as
+  // for the BloomFilter constructor, or null if there is none.
+  BloomFilter* lookup(const uint8_t* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount);
+
+  // Like lookup(), but creates and caches the filter if there is none.
+  BloomFilter* insert(const uint8_t* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount);
+
+  // Like lookup() and insert(), for a base64-encoded bitmap as for the
+  // newBloomFilterFromBase64 export. The filters are keyed by the encoded text,
+  // so they are not found by lookup() or insert() of the decoded bitmap.
+  // insertBase64() returns null if the filter cannot be allocated.
+  BloomFilter* lookupBase64(const char* base64Bitmap, uint32_t base64BitmapLength, uint32_t padding, uint32_t hashCount);
+  BloomFilter* insertBase64(const char* base64Bitmap, uint32_t base64BitmapLength, uint32_t padding, uint32_t hashCount);
+
+  // Releases a filter returned by lookup() or insert(), which may delete it.
+  void release(BloomFilter* filter);
+
+  // The number of filters in the cache, including the ones in use.
+  size_t filterCount() const;
+
+  // The total BloomFilter::memoryUsage() of the filters in the cache,
+  // including the ones in use.
+  size_t memoryUsage() const;
+
+ private:
+  enum class Encoding : uint8_t {
+    Raw,
+    Base64,
+  };
+
+  struct Key {
+    uint64_t digestLow64;
+    uint64_t digestHigh64;
+    uint32_t bitmapLength;
+    uint32_t padding;
+    uint32_t hashCount;
+    Encoding encoding;
+
+    bool operator==(const Key& other) const = default;
+  };
+
+  struct KeyHasher {
+    // The digest is already uniformly distributed.
+    size_t operator()(const Key& key) const {
+      return static_cast<size_t>(key.digestLow64);
+    }
+  };
+
+  struct Entry {
+    Key key;
+    BloomFilter* filter;
+    size_t memoryUsage;
+    uint32_t referenceCount;
+  };
+
+  typedef std::list<Entry>::iterator EntryIterator;
+
+  size_t _maxBytes;
+  size_t _memoryUsage = 0;
+  // Most recently used first.
+  std::list<Entry> _entries;
+  std::unordered_map<Key, EntryIterator, KeyHasher> _entriesByKey;
+  std::unordered_map<const BloomFilter*, EntryIterator> _entriesByFilter;
+#if WASMDEMO_THREADS
+  mutable std::mutex _mutex;
+#endif
+
+  static Key keyFor(const void* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount, Encoding encoding);
+
+  BloomFilter* lookup(const Key& key);
+
+  // Returns the filter with the given key, creating it with `create()` and
+  // caching it if there is none.
+  template <typename Create>
+  BloomFilter* insert(const Key& key, Create create);
+
+  // Returns the filter of the entry with the given key, with a new reference,
+  // or null if there is none. The caller holds the lock.
+  BloomFilter* acquire(const Key& key);
+
+  // Deletes the least recently used filters that are not in use until the
+  // filters fit in the budget, or only the ones in use are left.
+  void evict();
+};
+
+// Creates a BloomFilterCache; see BloomFilterCache.
+WASM_EXPORT("newBloomFilterCache")
+BloomFilterCache* newBloomFilterCache(int32_t maxBytes);
+
+WASM_EXPORT("deleteBloomFilterCache")
+void deleteBloomFilterCache(BloomFilterCache* cache);
+
+// Returns null if the filter is not cached. A filter that is returned must be
+// released with bloomFilterCacheRelease() rather than deleteBloomFilter().
+WASM_EXPORT("bloomFilterCacheLookup")
+BloomFilter* bloomFilterCacheLookup(BloomFilterCache* cache, const int8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount);
+
+// Like bloomFilterCacheLookup(), but creates and caches the filter, as
+// newBloomFilter() would, if it is not cached.
+WASM_EXPORT("bloomFilterCacheInsert")
+BloomFilter* bloomFilterCacheInsert(BloomFilterCache* cache, const int8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount);
+
+// Like bloomFilterCacheLookup() and bloomFilterCacheInsert(), for a base64
+// bitmap as for newBloomFilterFromBase64(). bloomFilterCacheInsertBase64()
+// returns null if the filter cannot be allocated.
+WASM_EXPORT("bloomFilterCacheLookupBase64")
+BloomFilter* bloomFilterCacheLookupBase64(BloomFilterCache* cache, const char* base64Bitmap, int32_t base64BitmapLength, int32_t padding, int32_t hashCount);
+
+WASM_EXPORT("bloomFilterCacheInsertBase64")
+BloomFilter* bloomFilterCacheInsertBase64(BloomFilterCache* cache, const char* base64Bitmap, int32_t base64BitmapLength, int32_t padding, int32_t hashCount);
+
+WASM_EXPORT("bloomFilterCacheRelease")
+void bloomFilterCacheRelease(BloomFilterCache* cache, BloomFilter* filter);
+
+#endif // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_BLOOM_CACHE_H_
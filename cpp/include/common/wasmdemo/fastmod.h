@@ -0,0 +1,67 @@
+#ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_FASTMOD_H_
+#define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_FASTMOD_H_
+
+#include <cstdint>
+
+// Computes remainders of 64-bit numbers by a 32-bit divisor that is fixed when
+// the FastModulo is created, with a few multiplications by a precomputed
+// reciprocal instead of a 64-bit division, which is especially slow on wasm32.
+// The results are exact, i.e. identical to `n % divisor`.
+//
+// This is the "direct computation" method from Lemire, Kaser and Kurz, "Faster
+// Remainder by Direct Computation" (2019), with a 128-bit reciprocal, which is
+// exact for all 64-bit numerators since the divisor has at most 32 bits.
+class FastModulo {
+ public:
+  // Creates a FastModulo for the given divisor, which must not be zero.
+  explicit FastModulo(uint32_t divisor);
+
+  uint32_t divisor() const {
+    return _divisor;
+  }
+
+  // Returns `n % divisor()`.
+  uint32_t mod(uint64_t n) const {
+    // The fractional bits of n / divisor: the low 128 bits of n * reciprocal.
+    uint64_t fractionHigh, fractionLow;
+    multiply64(_reciprocalLow, n, fractionHigh, fractionLow);
+    fractionHigh += _reciprocalHigh * n;
+
+    // The remainder is the integral part of fraction * divisor / 2^128.
+    uint64_t lowProductHigh, unusedLowProductLow;
+    multiply64(fractionLow, _divisor, lowProductHigh, unusedLowProductLow);
+    uint64_t highProductHigh, highProductLow;
+    multiply64(fractionHigh, _divisor, highProductHigh, highProductLow);
+    const uint64_t carry = highProductLow + lowProductHigh < highProductLow ? 1 : 0;
+    return static_cast<uint32_t>(highProductHigh + carry);
+  }
+
+ private:
+  uint64_t _reciprocalHigh;
+  uint64_t _reciprocalLow;
+  uint32_t _divisor;
+
+  // Sets `high` and `low` to the upper and lower halves of the 128-bit product
+  // of `a` and `b`.
+  static void multiply64(uint64_t a, uint64_t b, uint64_t& high, uint64_t& low) {
+#if defined(__SIZEOF_INT128__) && !defined(__wasm__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 product = static_cast<uint128>(a) * b;
+    high = static_cast<uint64_t>(product >> 64);
+    low = static_cast<uint64_t>(product);
+#else
+    // wasm32 has no 64x64->128 multiply instruction, and clang lowers 128-bit
+    // multiplications to a libcall, so multiply 32-bit halves instead.
+    const uint64_t aLow = a & 0xffffffff, aHigh = a >> 32;
+    const uint64_t bLow = b & 0xffffffff, bHigh = b >> 32;
+    const uint64_t lowLow = aLow * bLow;
+    const uint64_t highLow = aHigh * bLow;
+    const uint64_t lowHigh = aLow * bHigh;
+    const uint64_t middle = (lowLow >> 32) + (highLow & 0xffffffff) + lowHigh;
+    high = aHigh * bHigh + (highLow >> 32) + (middle >> 32);
+    low = (middle << 32) | (lowLow & 0xffffffff);
+#endif
+  }
+};
+
+#endif // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_FASTMOD_H_
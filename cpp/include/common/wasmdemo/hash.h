@@ -40,9 +40,59 @@ extern void MD5_Init(MD5_CTX *ctx);
 extern void MD5_Update(MD5_CTX *ctx, const void *data, unsigned int size);
 extern void MD5_Final(unsigned char *result, MD5_CTX *ctx);
 
+/*
+ * Computes the digests of count independent messages, where message i is the
+ * sizes[i] bytes at data[i], and writes digest i to &results[i * 16].  The
+ * digests are identical to those from MD5_Init/MD5_Update/MD5_Final, but short
+ * messages are hashed several at a time in SIMD lanes when available.
+ */
+extern void MD5_Multi(const void *const *data, const unsigned int *sizes,
+	unsigned int count, unsigned char *results);
+
+/*
+ * Like MD5_Multi(), but message i is the bytes already hashed into prefix,
+ * which is not modified, followed by the sizes[i] bytes at data[i].
+ *
+ * An MD5_CTX is a plain struct, so the state after hashing a prefix that many
+ * messages share (e.g. a document path) can be captured once and copied for
+ * each message; that, or this function, compresses the prefix's full 64-byte
+ * blocks only once instead of once per message.
+ */
+extern void MD5_Multi_Prefixed(const MD5_CTX *prefix, const void *const *data,
+	const unsigned int *sizes, unsigned int count, unsigned char *results);
+
+#include <cstdint>
+
 #include "wasmdemo/macros.h"
 
+// Returns the MD5 digest of the given string in a static buffer, which the next
+// call overwrites; hashMulti() and the hashInit() family write to buffers that
+// the caller owns instead.
 WASM_EXPORT("hash")
 unsigned char* hash(const char *str, unsigned int size);
 
+// Writes the MD5 digests of `count` inputs packed back-to-back in `data`, where
+// input `i` spans `data[offsets[i]]` up to (but not including)
+// `data[offsets[i + 1]]`, to `results[i * 16]` through `results[i * 16 + 15]`.
+WASM_EXPORT("hashMulti")
+void hashMulti(const char *data, const int32_t *offsets, int32_t count, unsigned char *results);
+
+// The size of the context that the caller allocates for hashInit(),
+// hashUpdate(), and hashFinal(), which hash an input given in any number of
+// chunks, so that it never has to be in linear memory all at once. Contexts are
+// independent, so any number of inputs may be hashed at the same time.
+WASM_EXPORT("hashContextSize")
+int32_t hashContextSize();
+
+WASM_EXPORT("hashInit")
+void hashInit(MD5_CTX *context);
+
+WASM_EXPORT("hashUpdate")
+void hashUpdate(MD5_CTX *context, const char *data, int32_t size);
+
+// Writes the 16-byte digest to `result`. The context must be initialized again
+// before it is reused.
+WASM_EXPORT("hashFinal")
+void hashFinal(MD5_CTX *context, unsigned char *result);
+
 #endif  // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_HASH_H_
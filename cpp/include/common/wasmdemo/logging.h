@@ -0,0 +1,86 @@
+#ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_LOGGING_H_
+#define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_LOGGING_H_
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "wasmdemo/macros.h"
+
+// The severity of a log message. The values are also those of the
+// WASMDEMO_MIN_LOG_LEVEL compile definition and of the setLogLevel export.
+enum class LogLevel : uint8_t {
+  Debug = 0,
+  Info = 1,
+  Warning = 2,
+  Error = 3,
+};
+
+// Messages below this level are compiled out; 4 compiles out every message.
+// The build sets it from the WASMDEMO_MIN_LOG_LEVEL cmake option.
+#ifndef WASMDEMO_MIN_LOG_LEVEL
+#define WASMDEMO_MIN_LOG_LEVEL 1
+#endif
+
+constexpr bool isLogLevelCompiledIn(LogLevel level) {
+  return level >= static_cast<LogLevel>(WASMDEMO_MIN_LOG_LEVEL);
+}
+
+// Formats a log message in a fixed-size buffer, without allocating. Text past
+// the capacity is dropped.
+class LogLine {
+ public:
+  static constexpr uint32_t CAPACITY = 256;
+
+  LogLine& operator<<(std::string_view text);
+
+  template <typename T>
+    requires std::is_integral_v<T>
+  LogLine& operator<<(T value) {
+    char digits[24];
+    const char* const end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    return *this << std::string_view(digits, static_cast<size_t>(end - digits));
+  }
+
+  std::string_view text() const {
+    return std::string_view(_text, _length);
+  }
+
+ private:
+  char _text[CAPACITY];
+  uint32_t _length = 0;
+};
+
+// Appends a line with the message to the log buffer, unless `level` is below
+// the one set with setLogLevel(). The buffer is passed to the `log` import in
+// one call, as lines that each end with '\n', when the next message does not
+// fit, when an Error is logged, and by flushLog(). Messages should not contain
+// '\n' themselves.
+void writeLog(LogLevel level, std::string_view message);
+
+inline void writeLog(LogLevel level, const LogLine& message) {
+  writeLog(level, message.text());
+}
+
+// Logs `message`, a std::string_view or a LogLine, at the given level (Debug,
+// Info, Warning or Error). A message below WASMDEMO_MIN_LOG_LEVEL costs
+// nothing: it is neither evaluated nor formatted, e.g.
+//   WASMDEMO_LOG(Debug, LogLine() << "size " << size);
+#define WASMDEMO_LOG(zz_level_zz, zz_message_zz) \
+  do { \
+    if constexpr (isLogLevelCompiledIn(LogLevel::zz_level_zz)) { \
+      writeLog(LogLevel::zz_level_zz, zz_message_zz); \
+    } \
+  } while (false)
+
+// Passes the buffered log lines to the `log` import, if there are any.
+WASM_EXPORT("flushLog")
+void flushLog();
+
+// Drops the messages below `level`, a LogLevel value, from then on; 4 drops
+// every message. Messages below WASMDEMO_MIN_LOG_LEVEL are dropped either way.
+WASM_EXPORT("setLogLevel")
+void setLogLevel(int32_t level);
+
+#endif // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_LOGGING_H_
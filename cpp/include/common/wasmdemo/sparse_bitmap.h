@@ -0,0 +1,48 @@
+#ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_SPARSE_BITMAP_H_
+#define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_SPARSE_BITMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A read-only bitmap that stores the indexes of its set bits instead of all of
+// its bits, for the bloom filters of small result sets, which have few bits set
+// in a bitmap that is sized for many more keys.
+//
+// Like the array containers of a Roaring bitmap, the bits are split into
+// containers of 2^16 bits, and each container holds the sorted lower 16 bits of
+// the indexes of its set bits. That takes 2 bytes per set bit, plus 4 bytes per
+// container, and testing a bit is a binary search within its container.
+class SparseBitmap {
+ public:
+  // The number of bits in a container.
+  static const uint32_t CONTAINER_BIT_COUNT = 1 << 16;
+
+  // Creates a SparseBitmap with the first `bitCount` bits of the given bitmap,
+  // where bit n is bit n % 8 of byte n / 8, if it would take at most a quarter
+  // of the memory of the bitmap itself; otherwise returns null, which is cheap,
+  // since it gives up as soon as too many bits are set.
+  static SparseBitmap* createIfSmaller(const uint8_t* bitmap, uint64_t bitCount);
+
+  SparseBitmap(const SparseBitmap&) = delete;
+  SparseBitmap& operator=(const SparseBitmap&) = delete;
+
+  bool isBitSet(uint64_t n) const;
+
+  uint64_t setBitCount() const {
+    return _lowBits.size();
+  }
+
+  // The number of bytes of memory that the set bits take up.
+  size_t memoryUsage() const;
+
+ private:
+  // Container c holds _lowBits[_containerStarts[c]] up to (but not including)
+  // _lowBits[_containerStarts[c + 1]].
+  std::vector<uint32_t> _containerStarts;
+  std::vector<uint16_t> _lowBits;
+
+  SparseBitmap() = default;
+};
+
+#endif // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_SPARSE_BITMAP_H_
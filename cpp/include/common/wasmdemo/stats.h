@@ -0,0 +1,124 @@
+#ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_STATS_H_
+#define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_STATS_H_
+
+#include <cstdint>
+
+#include "wasmdemo/macros.h"
+
+// The number of buckets of WasmdemoStats::bloomNegativeProbeDepths.
+const uint32_t BLOOM_PROBE_DEPTH_BUCKET_COUNT = 16;
+
+// Counters of what the module has done since it started, or since the last
+// resetStats(), for attributing latency without a profiler. They are only
+// maintained in builds with WASMDEMO_STATS=1 (the WASMDEMO_STATS cmake
+// option); otherwise every counter stays 0, and counting costs nothing.
+//
+// readStats() returns this struct as is: a uint32_t version and a uint32_t
+// flag, followed by uint64_t counters in declaration order, without padding.
+// Fields are only ever appended, along with a new version.
+struct WasmdemoStats {
+  // WASMDEMO_STATS_VERSION.
+  uint32_t version;
+  // 1 if the counters are maintained, 0 if they are compiled out.
+  uint32_t enabled;
+
+  // BloomFilter objects created, and the time spent in their constructors,
+  // e.g. copying the bitmap or converting it to a SparseBitmap.
+  uint64_t bloomFiltersCreated;
+  uint64_t bloomCreateNanos;
+  // Keys or digests tested against a non-empty BloomFilter, and how many of
+  // them might be contained.
+  uint64_t bloomProbes;
+  uint64_t bloomPositives;
+  // Bucket i counts the negative probes that stopped at the (i + 1)th bit they
+  // tested; the last bucket also counts the ones that stopped later.
+  uint64_t bloomNegativeProbeDepths[BLOOM_PROBE_DEPTH_BUCKET_COUNT];
+  // The time spent in BloomFilter::mightContainBatch() and
+  // mightContainHashes(), including hashing; single probes are not timed.
+  uint64_t bloomBatchProbeNanos;
+
+  // 64-byte blocks compressed by MD5, in any lane of MD5_Multi().
+  uint64_t md5Blocks;
+
+  // Bytes produced by base64 decoding, and the time spent decoding the bitmaps
+  // of newBloomFilterFromBase64().
+  uint64_t base64DecodedBytes;
+  uint64_t base64DecodeNanos;
+
+  // Blocks handed out by Arena and SizeClassPool (e.g. the malloc export), and
+  // their requested sizes.
+  uint64_t allocations;
+  uint64_t allocatedBytes;
+};
+
+const uint32_t WASMDEMO_STATS_VERSION = 1;
+
+static_assert(sizeof(WasmdemoStats) == 8 + (10 + BLOOM_PROBE_DEPTH_BUCKET_COUNT) * 8,
+              "WasmdemoStats must not have padding");
+
+#if WASMDEMO_STATS
+
+// The live counters; use WASMDEMO_STATS_ADD() and WASMDEMO_STATS_TIMER() to
+// update them.
+extern WasmdemoStats gStats;
+
+inline void addStat(uint64_t& counter, uint64_t value) {
+#if WASMDEMO_THREADS
+  __atomic_fetch_add(&counter, value, __ATOMIC_RELAXED);
+#else
+  counter += value;
+#endif
+}
+
+// The time of the monotonic clock (clock_time_get under WASI), in nanoseconds.
+uint64_t statsClockNanos();
+
+// Adds the time from its construction to its destruction to a counter.
+class StatsTimer {
+ public:
+  explicit StatsTimer(uint64_t& counter) : _counter(counter), _startNanos(statsClockNanos()) {
+  }
+
+  StatsTimer(const StatsTimer&) = delete;
+  StatsTimer& operator=(const StatsTimer&) = delete;
+
+  ~StatsTimer() {
+    addStat(_counter, statsClockNanos() - _startNanos);
+  }
+
+ private:
+  uint64_t& _counter;
+  uint64_t _startNanos;
+};
+
+// Adds `value` to the counter `field` of gStats, e.g.
+//   WASMDEMO_STATS_ADD(md5Blocks, size / 64);
+#define WASMDEMO_STATS_ADD(zz_field_zz, zz_value_zz) \
+  addStat(gStats.zz_field_zz, static_cast<uint64_t>(zz_value_zz))
+
+// Adds the time until the end of the enclosing scope to the counter `field`.
+#define WASMDEMO_STATS_TIMER(zz_field_zz) \
+  StatsTimer zz_stats_timer_zz(gStats.zz_field_zz)
+
+#else
+
+// Without WASMDEMO_STATS, the arguments are not even evaluated.
+#define WASMDEMO_STATS_ADD(zz_field_zz, zz_value_zz) \
+  do { \
+  } while (false)
+
+#define WASMDEMO_STATS_TIMER(zz_field_zz) \
+  do { \
+  } while (false)
+
+#endif // WASMDEMO_STATS
+
+// Returns a snapshot of the counters, which is valid until the next call.
+WASM_EXPORT("readStats")
+const WasmdemoStats* readStats();
+
+// Sets every counter to 0.
+WASM_EXPORT("resetStats")
+void resetStats();
+
+#endif // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_STATS_H_
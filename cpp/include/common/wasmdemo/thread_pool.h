@@ -0,0 +1,64 @@
+#ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_THREAD_POOL_H_
+#define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_THREAD_POOL_H_
+
+#include <cstdint>
+#include <functional>
+
+#if WASMDEMO_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+// A fixed set of worker threads that run the tasks of one parallelFor() call at
+// a time. Builds without thread support (WASMDEMO_THREADS=0, e.g. plain
+// wasm32-wasi) get a pool that runs every task on the calling thread, so that
+// callers need no special cases.
+class ThreadPool {
+ public:
+  // Creates a pool whose parallelFor() runs tasks on `threadCount` threads,
+  // including the calling thread; 0 means one per hardware thread.
+  explicit ThreadPool(uint32_t threadCount);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool();
+
+  // The number of threads that run tasks, including the calling thread.
+  uint32_t threadCount() const;
+
+  // Calls `task(i)` once for every i in [0, taskCount), spread across the
+  // threads, and returns when all of the calls have returned. Must not be
+  // called concurrently, or from a task.
+  void parallelFor(uint32_t taskCount, const std::function<void(uint32_t)>& task);
+
+#if WASMDEMO_THREADS
+ private:
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  std::condition_variable _workAvailable;
+  std::condition_variable _workDone;
+  // Incremented for every parallelFor() call, and by the destructor, to wake
+  // the workers.
+  uint64_t _generation = 0;
+  bool _stopping = false;
+  const std::function<void(uint32_t)>* _task = nullptr;
+  uint32_t _taskCount = 0;
+  std::atomic<uint32_t> _nextTask {0};
+  uint32_t _busyWorkerCount = 0;
+
+  void runWorker();
+  void runTasks();
+#endif
+};
+
+// Calls `function` with a process-wide pool of `threadCount` threads (0 means
+// one per hardware thread), which is created on first use and re-created when a
+// call asks for a different thread count. Concurrent calls are serialized, so
+// that separate callers never share the pool's parallelFor().
+void withSharedThreadPool(uint32_t threadCount, const std::function<void(ThreadPool&)>& function);
+
+#endif // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_THREAD_POOL_H_
@@ -9,6 +9,9 @@ void log(const char* s, int32_t len);
 WASM_EXPORT("echo")
 void echo(const char* s, int32_t len);
 
+WASM_EXPORT("echo_signed_unsigned")
+void echo_signed_unsigned(int32_t sint, uint32_t usint);
+
 WASM_EXPORT("add")
 int add(int num1, int num2);
 
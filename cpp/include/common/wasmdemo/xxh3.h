@@ -0,0 +1,19 @@
+#ifndef WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_XXH3_H_
+#define WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_XXH3_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// A 128-bit xxHash3 digest.
+struct Xxh3Hash128 {
+  uint64_t low64;
+  uint64_t high64;
+};
+
+// Returns the same digest as XXH3_128bits() from xxHash 0.8 (i.e. with the
+// default secret and a seed of zero), computed with portable scalar code. It is
+// not a cryptographic hash, but it is many times faster than MD5 and
+// distributes keys as well for the purposes of a bloom filter.
+Xxh3Hash128 xxh3Hash128(const void* data, size_t size);
+
+#endif // WASMDEMO_CPP_INCLUDE_COMMON_WASMDEMO_XXH3_H_
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "wasmdemo/allocator.h"
+#include "wasmdemo/macros.h"
+#include "wasmdemo/stats.h"
+
+namespace {
+
+// The size of the header in front of every Arena block and SizeClassPool
+// block, which keeps what follows it aligned like malloc().
+const uint32_t HEADER_SIZE = 16;
+
+// The size of the slabs that SizeClassPool carves its blocks from.
+const size_t SLAB_SIZE = 32 * 1024;
+
+// SizeClassPool's header for blocks that it got straight from malloc().
+const uint32_t LARGE_SIZE_CLASS = UINT32_MAX;
+
+uint32_t alignUp(uint32_t size, uint32_t alignment) {
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t& sizeClassOf(void* block) {
+  return *reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(block) - HEADER_SIZE);
+}
+
+SizeClassPool& exportPool() {
+  // Never deleted, so that blocks may still be freed during exit.
+  static SizeClassPool* pool = new SizeClassPool();
+  return *pool;
+}
+
+} // namespace
+
+struct Arena::Block {
+  Block* next;
+  // The size of the block, including this header.
+  uint32_t size;
+};
+
+Arena::Arena(uint32_t blockSize) : _blockSize(alignUp(std::max(blockSize, HEADER_SIZE + ALIGNMENT), ALIGNMENT)) {
+  static_assert(sizeof(Block) <= HEADER_SIZE);
+}
+
+Arena::~Arena() {
+  Block* block = _firstBlock;
+  while (block) {
+    Block* next = block->next;
+    std::free(block);
+    block = next;
+  }
+}
+
+void* Arena::alloc(uint32_t size) {
+  WASMDEMO_STATS_ADD(allocations, 1);
+  WASMDEMO_STATS_ADD(allocatedBytes, size);
+  if (size > UINT32_MAX - HEADER_SIZE - ALIGNMENT) {
+    return nullptr;
+  }
+  const uint32_t alignedSize = alignUp(size, ALIGNMENT);
+
+  // Move on through the blocks kept by reset() until one has room.
+  while (_currentBlock && alignedSize > _currentBlock->size - _offset) {
+    if (!_currentBlock->next) {
+      break;
+    }
+    _currentBlock = _currentBlock->next;
+    _offset = HEADER_SIZE;
+  }
+
+  if (!_currentBlock || alignedSize > _currentBlock->size - _offset) {
+    const uint32_t blockSize = std::max(_blockSize, HEADER_SIZE + alignedSize);
+    auto* block = static_cast<Block*>(aligned_alloc(ALIGNMENT, blockSize));
+    if (!block) {
+      return nullptr;
+    }
+    block->next = nullptr;
+    block->size = blockSize;
+    if (_currentBlock) {
+      _currentBlock->next = block;
+    } else {
+      _firstBlock = block;
+    }
+    _currentBlock = block;
+    _offset = HEADER_SIZE;
+  }
+
+  void* const result = reinterpret_cast<uint8_t*>(_currentBlock) + _offset;
+  _offset += alignedSize;
+  return result;
+}
+
+void Arena::reset() {
+  _currentBlock = _firstBlock;
+  _offset = HEADER_SIZE;
+}
+
+size_t Arena::capacity() const {
+  size_t capacity = 0;
+  for (const Block* block = _firstBlock; block; block = block->next) {
+    capacity += block->size;
+  }
+  return capacity;
+}
+
+SizeClassPool::~SizeClassPool() {
+  Slab* slab = _slabs;
+  while (slab) {
+    Slab* next = slab->next;
+    std::free(slab);
+    slab = next;
+  }
+}
+
+void* SizeClassPool::alloc(size_t size) {
+  WASMDEMO_STATS_ADD(allocations, 1);
+  WASMDEMO_STATS_ADD(allocatedBytes, size);
+  if (size > MAX_CLASS_SIZE) {
+    if (size > SIZE_MAX - HEADER_SIZE) {
+      return nullptr;
+    }
+    auto* block = static_cast<uint8_t*>(malloc(HEADER_SIZE + size));
+    if (!block) {
+      return nullptr;
+    }
+    sizeClassOf(block + HEADER_SIZE) = LARGE_SIZE_CLASS;
+    return block + HEADER_SIZE;
+  }
+
+  // The smallest class, MIN_CLASS_SIZE << sizeClass, that fits `size`.
+  const uint32_t sizeClass = size <= MIN_CLASS_SIZE
+      ? 0
+      : static_cast<uint32_t>(std::bit_width(size - 1) - std::bit_width(MIN_CLASS_SIZE - 1));
+
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+  if (!_freeLists[sizeClass] && !refill(sizeClass)) {
+    return nullptr;
+  }
+  FreeBlock* const block = _freeLists[sizeClass];
+  _freeLists[sizeClass] = block->next;
+  return block;
+}
+
+void SizeClassPool::free(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  const uint32_t sizeClass = sizeClassOf(ptr);
+  if (sizeClass == LARGE_SIZE_CLASS) {
+    std::free(static_cast<uint8_t*>(ptr) - HEADER_SIZE);
+    return;
+  }
+
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+  auto* const block = static_cast<FreeBlock*>(ptr);
+  block->next = _freeLists[sizeClass];
+  _freeLists[sizeClass] = block;
+}
+
+bool SizeClassPool::refill(uint32_t sizeClass) {
+  const size_t stride = HEADER_SIZE + (MIN_CLASS_SIZE << sizeClass);
+  const size_t blockCount = (SLAB_SIZE - HEADER_SIZE) / stride;
+  auto* const slab = static_cast<Slab*>(malloc(HEADER_SIZE + blockCount * stride));
+  if (!slab) {
+    return false;
+  }
+  slab->next = _slabs;
+  _slabs = slab;
+
+  // Push the blocks in reverse, so that they are handed out in address order.
+  uint8_t* const firstBlock = reinterpret_cast<uint8_t*>(slab) + HEADER_SIZE + HEADER_SIZE;
+  for (size_t i = blockCount; i > 0; i--) {
+    uint8_t* const block = firstBlock + (i - 1) * stride;
+    sizeClassOf(block) = sizeClass;
+    auto* const freeBlock = reinterpret_cast<FreeBlock*>(block);
+    freeBlock->next = _freeLists[sizeClass];
+    _freeLists[sizeClass] = freeBlock;
+  }
+  return true;
+}
+
+WASM_EXPORT("malloc")
+void* my_wasm_malloc(int size) {
+  if (size < 0) {
+    abort();
+  }
+  return exportPool().alloc(static_cast<size_t>(size));
+}
+
+WASM_EXPORT("free")
+void my_wasm_free(void* ptr) {
+  exportPool().free(ptr);
+}
+
+WASM_EXPORT("arenaCreate")
+Arena* arenaCreate(int32_t blockSize) {
+  if (blockSize < 0) {
+    abort();
+  }
+  return new Arena(static_cast<uint32_t>(blockSize));
+}
+
+WASM_EXPORT("arenaAlloc")
+void* arenaAlloc(Arena* arena, int32_t size) {
+  if (size < 0) {
+    abort();
+  }
+  return arena->alloc(static_cast<uint32_t>(size));
+}
+
+WASM_EXPORT("arenaReset")
+void arenaReset(Arena* arena) {
+  arena->reset();
+}
+
+WASM_EXPORT("arenaDestroy")
+void arenaDestroy(Arena* arena) {
+  delete arena;
+}
@@ -33,9 +33,13 @@
 // THIS VERSION HAS BEEN ALTERED by reao@google.com
 
 #include "wasmdemo/base64.h"
+#include "wasmdemo/stats.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
+#include <string_view>
 
  //
  // Depending on the url parameter in base64_chars, one of
@@ -68,27 +72,13 @@ static unsigned int pos_of_char(const unsigned char chr) {
     return 0xdeadbeef;
 }
 
-static std::string insert_linebreaks(std::string str, size_t distance) {
- //
- // Provided by https://github.com/JomaCorpFX, adapted by me.
- //
-    if (!str.length()) {
-        return "";
-    }
-
-    size_t pos = distance;
-
-    while (pos < str.size()) {
-        str.insert(pos, "\n");
-        pos += distance + 1;
-    }
-
-    return str;
-}
-
+#if !WASMDEMO_MINIMAL
 template <typename String, unsigned int line_length>
 static std::string encode_with_line_breaks(String s) {
-  return insert_linebreaks(base64_encode(s, false), line_length);
+  std::string ret(base64_encoded_size(s.length(), line_length), '\0');
+  base64_encode_into(std::span(reinterpret_cast<const unsigned char*>(s.data()), s.length()),
+                     std::span(ret), false, line_length);
+  return ret;
 }
 
 template <typename String>
@@ -105,10 +95,132 @@ template <typename String>
 static std::string encode(String s, bool url) {
   return base64_encode(reinterpret_cast<const unsigned char*>(s.data()), s.length(), url);
 }
+#endif  // !WASMDEMO_MINIMAL
 
-std::string base64_encode(unsigned char const* bytes_to_encode, size_t in_len, bool url) {
+//
+// Vectorized kernels, in the style of Wojciech Muła's and Daniel Lemire's
+// SIMD base64 codecs: characters are translated with range comparisons, the
+// sextets of each group of four are merged in 32-bit lanes, and a byte shuffle
+// compacts (or expands) the groups. They are written with GCC/Clang vector
+// extensions, which compile to WebAssembly SIMD128 with -msimd128, to SSE2 (or
+// SSSE3/AVX2, where available) on x86, and to NEON on ARM. Both kernels only
+// handle whole 16-byte blocks and leave the rest to the scalar code.
+//
+#if (defined(__SSE2__) || defined(__wasm_simd128__) || defined(__ARM_NEON)) \
+    && (defined(__clang__) || __GNUC__ >= 12) \
+    && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define BASE64_SIMD 1
+#else
+#define BASE64_SIMD 0
+#endif
 
-    size_t len_encoded = (in_len +2) / 3 * 4;
+#if BASE64_SIMD
+
+typedef unsigned char base64_u8x16  __attribute__((vector_size(16)));
+typedef uint32_t      base64_u32x4  __attribute__((vector_size(16)));
+typedef uint64_t      base64_u64x2  __attribute__((vector_size(16)));
+
+static size_t decode_blocks_simd(const char* encoded, size_t length, unsigned char* dest) {
+ //
+ // Decode 16 characters into 12 bytes at a time, and return the number of
+ // characters consumed. Stop at the first block that contains anything other
+ // than alphabet characters (e.g. padding), which is left to the scalar code.
+ //
+    size_t pos = 0;
+
+    while (pos + 16 <= length) {
+       base64_u8x16 in;
+       std::memcpy(&in, encoded + pos, sizeof(in));
+
+       const base64_u8x16 upper = reinterpret_cast<base64_u8x16>((in >= 'A') & (in <= 'Z'));
+       const base64_u8x16 lower = reinterpret_cast<base64_u8x16>((in >= 'a') & (in <= 'z'));
+       const base64_u8x16 digit = reinterpret_cast<base64_u8x16>((in >= '0') & (in <= '9'));
+       const base64_u8x16 plus  = reinterpret_cast<base64_u8x16>((in == '+') | (in == '-'));
+       const base64_u8x16 slash = reinterpret_cast<base64_u8x16>((in == '/') | (in == '_'));
+
+       const base64_u64x2 valid = reinterpret_cast<base64_u64x2>(upper | lower | digit | plus | slash);
+       if ((valid[0] & valid[1]) != ~static_cast<uint64_t>(0)) break;
+
+       const base64_u32x4 sextets = reinterpret_cast<base64_u32x4>(
+             (upper & (in - 'A'))
+           | (lower & (in - 'a' + 26))
+           | (digit & (in - '0' + 52))
+           | (plus  & 62)
+           | (slash & 63));
+
+    //
+    // Each 32-bit lane holds the sextets of one group in its four bytes; merge
+    // them into the 24-bit value whose bytes, most significant first, are the
+    // group's three output bytes.
+    //
+       const base64_u32x4 merged =
+             ( (sextets         & 0x3f) << 18)
+           | (((sextets >>  8)  & 0x3f) << 12)
+           | (((sextets >> 16)  & 0x3f) <<  6)
+           |   (sextets >> 24);
+
+       const base64_u8x16 merged_bytes = reinterpret_cast<base64_u8x16>(merged);
+       const base64_u8x16 out = __builtin_shufflevector(merged_bytes, merged_bytes,
+           2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 3, 7, 11, 15);
+       std::memcpy(dest, &out, 12);
+
+       dest += 12;
+       pos  += 16;
+    }
+
+    return pos;
+}
+
+static size_t encode_blocks_simd(const unsigned char* bytes, size_t length, char* dest, const char* chars) {
+ //
+ // Encode 12 bytes into 16 characters at a time, and return the number of
+ // bytes consumed. Each block reads 16 bytes, so the last 4 bytes of the input
+ // are always left to the scalar code.
+ //
+    const unsigned char char_62 = static_cast<unsigned char>(chars[62]);
+    const unsigned char char_63 = static_cast<unsigned char>(chars[63]);
+
+    size_t pos = 0;
+
+    while (pos + 16 <= length) {
+       base64_u8x16 in;
+       std::memcpy(&in, bytes + pos, sizeof(in));
+
+    //
+    // Spread each group of three bytes over a 32-bit lane, most significant
+    // byte first, and split the lane into its four sextets.
+    //
+       const base64_u32x4 group = reinterpret_cast<base64_u32x4>(__builtin_shufflevector(in, in,
+           2, 1, 0, 0, 5, 4, 3, 3, 8, 7, 6, 6, 11, 10, 9, 9));
+
+       const base64_u8x16 sextets = reinterpret_cast<base64_u8x16>(
+              ((group >> 18) & 0x3f)
+           | (((group >> 12) & 0x3f) <<  8)
+           | (((group >>  6) & 0x3f) << 16)
+           | (( group        & 0x3f) << 24));
+
+    //
+    // Translate the sextets by adding the offset of the range that each falls
+    // into: 'A' for 0..25, 'a' - 26 for 26..51, '0' - 52 for 52..61, and
+    // the alphabet's own characters for 62 and 63.
+    //
+       base64_u8x16 out = sextets + 'A';
+       out += reinterpret_cast<base64_u8x16>(sextets >= 26) & static_cast<unsigned char>('a' - 26 - 'A');
+       out += reinterpret_cast<base64_u8x16>(sextets >= 52) & static_cast<unsigned char>('0' - 52 - ('a' - 26));
+       out += reinterpret_cast<base64_u8x16>(sextets == 62) & static_cast<unsigned char>(char_62 - (62 + '0' - 52));
+       out += reinterpret_cast<base64_u8x16>(sextets == 63) & static_cast<unsigned char>(char_63 - (63 + '0' - 52));
+       std::memcpy(dest, &out, sizeof(out));
+
+       dest += 16;
+       pos  += 12;
+    }
+
+    return pos;
+}
+
+#endif  // BASE64_SIMD
+
+static size_t encode_into(unsigned char const* bytes_to_encode, size_t in_len, char* dest, bool url) {
 
     unsigned char trailing_char = url ? '.' : '=';
 
@@ -123,121 +235,264 @@ std::string base64_encode(unsigned char const* bytes_to_encode, size_t in_len, b
  //
     const char* base64_chars_ = base64_chars[url];
 
-    std::string ret;
-    ret.reserve(len_encoded);
+    char* out = dest;
+    size_t pos = 0;
 
-    unsigned int pos = 0;
+#if BASE64_SIMD
+    pos = encode_blocks_simd(bytes_to_encode, in_len, out, base64_chars_);
+    out += pos / 3 * 4;
+#endif  // BASE64_SIMD
 
     while (pos < in_len) {
-        ret.push_back(base64_chars_[(bytes_to_encode[pos + 0] & 0xfc) >> 2]);
+        *out++ = base64_chars_[(bytes_to_encode[pos + 0] & 0xfc) >> 2];
 
         if (pos+1 < in_len) {
-           ret.push_back(base64_chars_[((bytes_to_encode[pos + 0] & 0x03) << 4) + ((bytes_to_encode[pos + 1] & 0xf0) >> 4)]);
+           *out++ = base64_chars_[((bytes_to_encode[pos + 0] & 0x03) << 4) + ((bytes_to_encode[pos + 1] & 0xf0) >> 4)];
 
            if (pos+2 < in_len) {
-              ret.push_back(base64_chars_[((bytes_to_encode[pos + 1] & 0x0f) << 2) + ((bytes_to_encode[pos + 2] & 0xc0) >> 6)]);
-              ret.push_back(base64_chars_[  bytes_to_encode[pos + 2] & 0x3f]);
+              *out++ = base64_chars_[((bytes_to_encode[pos + 1] & 0x0f) << 2) + ((bytes_to_encode[pos + 2] & 0xc0) >> 6)];
+              *out++ = base64_chars_[  bytes_to_encode[pos + 2] & 0x3f];
            }
            else {
-              ret.push_back(base64_chars_[(bytes_to_encode[pos + 1] & 0x0f) << 2]);
-              ret.push_back(static_cast<char>(trailing_char));
+              *out++ = base64_chars_[(bytes_to_encode[pos + 1] & 0x0f) << 2];
+              *out++ = static_cast<char>(trailing_char);
            }
         }
         else {
 
-            ret.push_back(base64_chars_[(bytes_to_encode[pos + 0] & 0x03) << 4]);
-            ret.push_back(static_cast<char>(trailing_char));
-            ret.push_back(static_cast<char>(trailing_char));
+            *out++ = base64_chars_[(bytes_to_encode[pos + 0] & 0x03) << 4];
+            *out++ = static_cast<char>(trailing_char);
+            *out++ = static_cast<char>(trailing_char);
         }
 
         pos += 3;
     }
 
+    return static_cast<size_t>(out - dest);
+}
+
+static size_t insert_linebreaks(char* str, size_t length, size_t distance) {
+ //
+ // Spread the length characters at str out into lines of distance characters
+ // separated by '\n', in place. Lines are moved starting with the last one, so
+ // that each character is moved at most once.
+ //
+    if (distance == 0 || length <= distance) return length;
+
+    size_t num_linebreaks = (length - 1) / distance;
+    size_t src_end = length;
+    size_t dest_end = length + num_linebreaks;
+    size_t line_length = length - num_linebreaks * distance;
+
+    while (dest_end != src_end) {
+        std::memmove(str + dest_end - line_length, str + src_end - line_length, line_length);
+        src_end -= line_length;
+        dest_end -= line_length;
+        str[--dest_end] = '\n';
+        line_length = distance;
+    }
+
+    return length + num_linebreaks;
+}
+
+size_t base64_encoded_size(size_t len, size_t line_length) {
+    size_t len_encoded = (len + 2) / 3 * 4;
+
+    if (line_length == 0 || len_encoded == 0) return len_encoded;
+    return len_encoded + (len_encoded - 1) / line_length;
+}
+
+size_t base64_encode_into(std::span<const unsigned char> bytes, std::span<char> dest, bool url, size_t line_length) {
+    if (dest.size() < base64_encoded_size(bytes.size(), line_length)) return 0;
+
+    size_t len_encoded = encode_into(bytes.data(), bytes.size(), dest.data(), url);
+    return insert_linebreaks(dest.data(), len_encoded, line_length);
+}
+
+#if !WASMDEMO_MINIMAL
+std::string base64_encode(unsigned char const* bytes_to_encode, size_t in_len, bool url) {
+
+    std::string ret(base64_encoded_size(in_len), '\0');
+    encode_into(bytes_to_encode, in_len, ret.data(), url);
 
     return ret;
 }
+#endif  // !WASMDEMO_MINIMAL
 
-template <typename String>
-static std::string decode(String const& encoded_string, bool remove_linebreaks) {
+static bool is_padding_char(const char chr) {
  //
- // decode(…) is templated so that it can be used with String = const std::string&
- // or std::string_view (requires at least C++17)
+ // Accept URL-safe base 64 strings, too, which are padded with '.'
  //
+    return chr == '=' || chr == '.';
+}
 
-    if (encoded_string.empty()) return std::string();
+static size_t decoded_size_of_chunk(std::string_view encoded, size_t pos) {
+ //
+ // Return the number of bytes produced by the chunk of (at most) 4 characters
+ // that starts at pos. The size of all chunks except the last one is 4 bytes,
+ // and they produce three output bytes.
+ //
+ // The last chunk might be padded with equal signs or dots in order to make it
+ // 4 bytes in size as well, but this is not required as per RFC 2045. It
+ // produces at least one and up to three bytes; a dangling single character
+ // cannot encode a whole byte and produces none.
+ //
+    if (pos + 1 >= encoded.length()) return 0;
+    if (pos + 2 >= encoded.length() || is_padding_char(encoded[pos + 2])) return 1;
+    if (pos + 3 >= encoded.length() || is_padding_char(encoded[pos + 3])) return 2;
+    return 3;
+}
 
-    if (remove_linebreaks) {
+size_t base64_decoded_size(std::string_view encoded, bool remove_linebreaks) {
+    if (!remove_linebreaks) {
+       if (encoded.empty()) return 0;
 
-       std::string copy(encoded_string);
+       size_t pos_of_last_chunk = (encoded.length() - 1) / 4 * 4;
+       return pos_of_last_chunk / 4 * 3 + decoded_size_of_chunk(encoded, pos_of_last_chunk);
+    }
 
-       copy.erase(std::remove(copy.begin(), copy.end(), '\n'), copy.end());
+ //
+ // Only the length of the text without line breaks and its last chunk matter.
+ //
+    size_t length = encoded.length() - static_cast<size_t>(std::count(encoded.begin(), encoded.end(), '\n'));
+    if (length == 0) return 0;
 
-       return base64_decode(copy, false);
+    char last_chunk[4];
+    size_t last_chunk_length = (length - 1) % 4 + 1;
+    for (size_t pos = encoded.length(), i = last_chunk_length; i > 0; ) {
+       if (encoded[--pos] != '\n') last_chunk[--i] = encoded[pos];
     }
 
-    size_t length_of_string = encoded_string.length();
+    return (length - last_chunk_length) / 4 * 3
+        + decoded_size_of_chunk(std::string_view(last_chunk, last_chunk_length), 0);
+}
+
+size_t base64_decode_into(std::string_view encoded, unsigned char* dest) {
+    unsigned char* out = dest;
     size_t pos = 0;
 
+#if BASE64_SIMD
  //
- // The approximate length (bytes) of the decoded string might be one or
- // two bytes smaller, depending on the amount of trailing equal signs
- // in the encoded string. This approximation is needed to reserve
- // enough space in the string to be returned.
+ // The last chunk is never decoded by the vectorized kernel, since it might be
+ // padded.
  //
-    size_t approx_length_of_decoded_string = length_of_string / 4 * 3;
-    std::string ret;
-    ret.reserve(approx_length_of_decoded_string);
+    if (encoded.length() > 4) {
+       pos = decode_blocks_simd(encoded.data(), encoded.length() - 4, out);
+       out += pos / 4 * 3;
+    }
+#endif  // BASE64_SIMD
 
-    while (pos < length_of_string) {
-    //
-    // Iterate over encoded input string in chunks. The size of all
-    // chunks except the last one is 4 bytes.
-    //
-    // The last chunk might be padded with equal signs or dots
-    // in order to make it 4 bytes in size as well, but this
-    // is not required as per RFC 2045.
-    //
-    // All chunks except the last one produce three output bytes.
-    //
-    // The last chunk produces at least one and up to three bytes.
-    //
+    for (; pos < encoded.length(); pos += 4) {
+       size_t chunk_size = decoded_size_of_chunk(encoded, pos);
+       if (chunk_size == 0) break;
 
-       size_t pos_of_char_1 = pos_of_char(static_cast<unsigned char>(encoded_string.at(
-           pos + 1)));
+       unsigned int pos_of_char_1 = pos_of_char(static_cast<unsigned char>(encoded[pos + 1]));
 
     //
     // Emit the first output byte that is produced in each chunk:
     //
-       ret.push_back(static_cast<std::string::value_type>( ( (pos_of_char(
-           static_cast<unsigned char>(encoded_string.at(pos + 0))) ) << 2 ) + ( (pos_of_char_1 & 0x30 ) >> 4)));
-
-       if ( ( pos + 2 < length_of_string  )       &&  // Check for data that is not padded with equal signs (which is allowed by RFC 2045)
-              encoded_string.at(pos+2) != '='     &&
-              encoded_string.at(pos+2) != '.'         // accept URL-safe base 64 strings, too, so check for '.' also.
-          )
-       {
+       *out++ = static_cast<unsigned char>( ( (pos_of_char(
+           static_cast<unsigned char>(encoded[pos + 0])) ) << 2 ) + ( (pos_of_char_1 & 0x30 ) >> 4));
+
+       if (chunk_size >= 2) {
        //
        // Emit a chunk's second byte (which might not be produced in the last chunk).
        //
-          unsigned int pos_of_char_2 = pos_of_char(static_cast<unsigned char>(encoded_string.at(
-              pos + 2)));
-          ret.push_back(static_cast<std::string::value_type>( (( pos_of_char_1 & 0x0f) << 4) + (( pos_of_char_2 & 0x3c) >> 2)));
-
-          if ( ( pos + 3 < length_of_string )     &&
-                 encoded_string.at(pos+3) != '='  &&
-                 encoded_string.at(pos+3) != '.'
-             )
-          {
+          unsigned int pos_of_char_2 = pos_of_char(static_cast<unsigned char>(encoded[pos + 2]));
+          *out++ = static_cast<unsigned char>( (( pos_of_char_1 & 0x0f) << 4) + (( pos_of_char_2 & 0x3c) >> 2));
+
+          if (chunk_size == 3) {
           //
           // Emit a chunk's third byte (which might not be produced in the last chunk).
           //
-             ret.push_back(static_cast<std::string::value_type>( ( (pos_of_char_2 & 0x03 ) << 6 ) + pos_of_char(
-                 static_cast<unsigned char>(encoded_string.at(pos + 3)))   ));
+             *out++ = static_cast<unsigned char>( ( (pos_of_char_2 & 0x03 ) << 6 ) + pos_of_char(
+                 static_cast<unsigned char>(encoded[pos + 3])));
           }
        }
+    }
+
+    WASMDEMO_STATS_ADD(base64DecodedBytes, out - dest);
+    return static_cast<size_t>(out - dest);
+}
+
+size_t base64_decode_into(std::string_view encoded, std::span<unsigned char> dest, bool remove_linebreaks) {
+    if (dest.size() < base64_decoded_size(encoded, remove_linebreaks)) return 0;
+
+    if (!remove_linebreaks) return base64_decode_into(encoded, dest.data());
+
+    Base64Decoder decoder(true);
+    size_t len_decoded = decoder.update(encoded, dest.data());
+    return len_decoded + decoder.finish(dest.data() + len_decoded);
+}
 
-       pos += 4;
+Base64Decoder::Base64Decoder(bool remove_linebreaks)
+    : _pending(), _pending_size(0), _remove_linebreaks(remove_linebreaks) {
+}
+
+size_t Base64Decoder::max_update_size(size_t len) const {
+    return (_pending_size + len) / 4 * 3;
+}
+
+size_t Base64Decoder::update(std::string_view encoded, unsigned char* dest) {
+    if (!_remove_linebreaks) return update_without_linebreaks(encoded, dest);
+
+    unsigned char* out = dest;
+    while (!encoded.empty()) {
+       size_t line_end = std::min(encoded.find('\n'), encoded.length());
+       out += update_without_linebreaks(encoded.substr(0, line_end), out);
+       encoded.remove_prefix(std::min(line_end + 1, encoded.length()));
     }
+    return static_cast<size_t>(out - dest);
+}
+
+size_t Base64Decoder::update_without_linebreaks(std::string_view encoded, unsigned char* dest) {
+    unsigned char* out = dest;
+
+ //
+ // Complete the group left over from the previous call first.
+ //
+    if (_pending_size > 0) {
+       size_t len_copied = std::min(4 - _pending_size, encoded.length());
+       std::memcpy(_pending + _pending_size, encoded.data(), len_copied);
+       _pending_size += len_copied;
+       encoded.remove_prefix(len_copied);
+
+       if (_pending_size < 4) return 0;
+
+       out += base64_decode_into(std::string_view(_pending, 4), out);
+       _pending_size = 0;
+    }
+
+    size_t len_complete = encoded.length() / 4 * 4;
+    out += base64_decode_into(encoded.substr(0, len_complete), out);
+
+    _pending_size = encoded.length() - len_complete;
+    std::memcpy(_pending, encoded.data() + len_complete, _pending_size);
+
+    return static_cast<size_t>(out - dest);
+}
+
+size_t Base64Decoder::finish(unsigned char* dest) {
+    size_t len_decoded = base64_decode_into(std::string_view(_pending, _pending_size), dest);
+    _pending_size = 0;
+    return len_decoded;
+}
+
+#if !WASMDEMO_MINIMAL
+template <typename String>
+static std::string decode(String const& encoded_string, bool remove_linebreaks) {
+ //
+ // decode(…) is templated so that it can be used with String = const std::string&
+ // or std::string_view (requires at least C++17)
+ //
+
+    if (encoded_string.empty()) return std::string();
+
+    const std::string_view encoded(encoded_string);
+
+    std::string ret(base64_decoded_size(encoded, remove_linebreaks), '\0');
+    ret.resize(base64_decode_into(encoded, std::span(reinterpret_cast<unsigned char*>(ret.data()), ret.length()),
+                                  remove_linebreaks));
 
     return ret;
 }
@@ -282,3 +537,4 @@ std::string base64_decode(std::string_view s, bool remove_linebreaks) {
 }
 
 #endif  // __cplusplus >= 201703L
+#endif  // !WASMDEMO_MINIMAL
@@ -1,20 +1,289 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "wasmdemo/base64.h"
 #include "wasmdemo/hash.h"
+#include "wasmdemo/logging.h"
 #include "wasmdemo/macros.h"
 #include "wasmdemo/bloom.h"
+#include "wasmdemo/stats.h"
+#include "wasmdemo/xxh3.h"
+
+#if !WASMDEMO_MINIMAL
+#include "wasmdemo/thread_pool.h"
+#endif
 
 /// bloom filter code starts here
 
-BloomFilter::BloomFilter(const uint8_t* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount)
-    : _size(bitmapLength * 8 - padding), _hashCount(hashCount) {
-  _bitmap = static_cast<uint8_t*>(malloc(bitmapLength));
-  memcpy(_bitmap, bitmap, bitmapLength);
+namespace {
+
+// The number of keys that mightContainBatch() hashes with each MD5_Multi() call.
+const uint32_t BATCH_CHUNK_SIZE = 64;
+
+#if !WASMDEMO_MINIMAL
+// The number of runs of keys per thread that the parallel mightContainBatch()
+// splits its keys into, so that a thread that finishes early can take on
+// another run instead of idling.
+const uint32_t PARALLEL_RUNS_PER_THREAD = 4;
+#endif
+
+// How many keys ahead of the one that it tests a batch prefetches the bits of:
+// enough for the misses of those keys to overlap, but few enough that their
+// cache lines are not evicted again before they are tested.
+const uint32_t PREFETCH_DISTANCE = 8;
+
+// The bitmap length from which BloomFilter prefetches, about the size of an L2
+// cache. The bits of a smaller filter are mostly cached already, and computing
+// their indexes a second time would only slow the probes down.
+const uint64_t PREFETCH_MIN_BITMAP_LENGTH = 1 << 20;
+
+// The largest hash count that BloomFilter has a specialized probe kernel for.
+// The backend picks the hash count for a false positive rate p as about
+// -log2(p), so this covers every rate down to 1 in 65536.
+const uint32_t MAX_SPECIALIZED_HASH_COUNT = 16;
+
+// The prefetch of a batch that does not prefetch.
+struct NoPrefetch {
+  void operator()(const uint8_t*) const {
+  }
+};
+
+// Calls `visit(i)` for every i in [0, count), in order, and `prefetch(i)`
+// PREFETCH_DISTANCE visits earlier, so that the memory that each visit waits on
+// is (hopefully) already on its way. This is a software-pipelined loop: while
+// one key is tested, the loads for the next few are in flight.
+template <typename Prefetch, typename Visit>
+void pipelined(uint32_t count, Prefetch prefetch, Visit visit) {
+  const uint32_t leadCount = std::min(count, PREFETCH_DISTANCE);
+  for (uint32_t i = 0; i < leadCount; i++) {
+    prefetch(i);
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (i + PREFETCH_DISTANCE < count) {
+      prefetch(i + PREFETCH_DISTANCE);
+    }
+    visit(i);
+  }
+}
+
+// The divisor of the Modulo index mapping for a filter of `size` bits. An empty
+// filter never reduces anything, so any divisor will do.
+FastModulo sizeModuloFor(uint64_t size) {
+  return FastModulo(size == 0 ? 1 : static_cast<uint32_t>(size));
+}
+
+// Maps a hashed value h(i) = h1 + (i * h2) to the index of the bit that it sets
+// in a filter of `size` bits. BloomFilter (its probe kernels and its prefetch)
+// and BloomFilterBuilder must agree on this exactly.
+template <BloomFilter::IndexMapping INDEX_MAPPING>
+inline uint64_t bitIndexFor(uint64_t hashValue, uint64_t size, const FastModulo& sizeModulo) {
+  if constexpr (INDEX_MAPPING == BloomFilter::IndexMapping::MultiplyShift) {
+    return ((hashValue >> 32) * size) >> 32;
+  } else {
+    return sizeModulo.mod(hashValue);
+  }
+}
+
+inline uint64_t bitIndexFor(BloomFilter::IndexMapping indexMapping, uint64_t hashValue, uint64_t size, const FastModulo& sizeModulo) {
+  if (indexMapping == BloomFilter::IndexMapping::MultiplyShift) {
+    return bitIndexFor<BloomFilter::IndexMapping::MultiplyShift>(hashValue, size, sizeModulo);
+  }
+  return bitIndexFor<BloomFilter::IndexMapping::Modulo>(hashValue, size, sizeModulo);
+}
+
+void md5(const char* value, uint32_t valueLength, uint8_t* outputHash) {
+  MD5_CTX hashContext;
+  MD5_Init(&hashContext);
+  MD5_Update(&hashContext, value, valueLength);
+  MD5_Final(outputHash, &hashContext);
+}
+
+// Writes the 16-byte XXH3_128bits() digest of the value, low half first, so
+// that the first 64 bits that the filters read back are `low64`.
+void xxh3(const char* value, uint32_t valueLength, uint8_t* outputHash) {
+  const Xxh3Hash128 hash = xxh3Hash128(value, valueLength);
+  memcpy(outputHash, &hash.low64, sizeof(hash.low64));
+  memcpy(outputHash + sizeof(hash.low64), &hash.high64, sizeof(hash.high64));
+}
+
+void hashKey(KeyHash keyHash, const char* value, uint32_t valueLength, uint8_t* outputHash) {
+  if (keyHash == KeyHash::XXH3_128) {
+    xxh3(value, valueLength, outputHash);
+  } else {
+    md5(value, valueLength, outputHash);
+  }
+}
+
+// Zeroes the storage past a bitmap of `bitmapLength` bytes, whose bits do not
+// matter but are loaded along with those of the last word of the bitmap.
+void clearStorageTail(uint8_t* bitmap, uint32_t bitmapLength) {
+  memset(bitmap + bitmapLength, 0, BloomFilter::storageSizeFor(bitmapLength) - bitmapLength);
+}
+
+bool isKnownKeyHash(uint32_t keyHash) {
+  return keyHash == static_cast<uint32_t>(KeyHash::MD5) || keyHash == static_cast<uint32_t>(KeyHash::XXH3_128);
+}
+
+bool isKnownIndexMapping(uint32_t indexMapping) {
+  return indexMapping == static_cast<uint32_t>(BloomFilter::IndexMapping::Modulo)
+      || indexMapping == static_cast<uint32_t>(BloomFilter::IndexMapping::MultiplyShift);
+}
+
+// Sets `key` to `prefix` followed by `suffix`, for hashes without a midstate.
+void assignPrefixedKey(std::vector<char>& key, const KeyPrefix& prefix, const char* suffix, uint32_t suffixLength) {
+  const std::string_view prefixString = prefix.prefix();
+  key.assign(prefixString.begin(), prefixString.end());
+  key.insert(key.end(), suffix, suffix + suffixLength);
+}
+
+// Hashes packed keys a chunk at a time (with MD5_Multi() for MD5, so that it
+// can fill its lanes), and calls `visit(i, digest)` for every non-empty key `i`,
+// with `prefetch(digest)` for each key a few visits earlier. If `prefix` is not
+// null, the keys are the packed suffixes appended to it.
+template <typename Visit, typename Prefetch = NoPrefetch>
+void forEachKeyHash(KeyHash keyHash, const KeyPrefix* const prefix, const char* const keys, const uint32_t* const offsets, uint32_t keyCount,
+                    Visit visit, Prefetch prefetch = {}) {
+  const void* chunkKeys[BATCH_CHUNK_SIZE];
+  unsigned int chunkKeyLengths[BATCH_CHUNK_SIZE];
+  uint8_t chunkHashes[BATCH_CHUNK_SIZE * 16];
+  // The prefix followed by the current suffix, for hashes without a midstate.
+  std::vector<char> prefixedKey;
+
+  for (uint32_t chunkStart = 0; chunkStart < keyCount; chunkStart += BATCH_CHUNK_SIZE) {
+    const uint32_t chunkSize = std::min(BATCH_CHUNK_SIZE, keyCount - chunkStart);
+    for (uint32_t j = 0; j < chunkSize; j++) {
+      const uint32_t keyStart = offsets[chunkStart + j];
+      chunkKeys[j] = keys + keyStart;
+      chunkKeyLengths[j] = offsets[chunkStart + j + 1] - keyStart;
+    }
+
+    if (keyHash != KeyHash::MD5) {
+      for (uint32_t j = 0; j < chunkSize; j++) {
+        const char* key = static_cast<const char*>(chunkKeys[j]);
+        uint32_t keyLength = chunkKeyLengths[j];
+        if (prefix) {
+          assignPrefixedKey(prefixedKey, *prefix, key, keyLength);
+          key = prefixedKey.data();
+          keyLength = static_cast<uint32_t>(prefixedKey.size());
+        }
+        hashKey(keyHash, key, keyLength, chunkHashes + j * 16);
+      }
+    } else if (prefix) {
+      MD5_Multi_Prefixed(&prefix->md5Context(), chunkKeys, chunkKeyLengths, chunkSize, chunkHashes);
+    } else {
+      MD5_Multi(chunkKeys, chunkKeyLengths, chunkSize, chunkHashes);
+    }
+
+    pipelined(
+        chunkSize,
+        [&](uint32_t j) { prefetch(chunkHashes + j * 16); },
+        [&](uint32_t j) {
+          const bool isEmpty = chunkKeyLengths[j] == 0 && (!prefix || prefix->length() == 0);
+          if (!isEmpty) {
+            visit(chunkStart + j, chunkHashes + j * 16);
+          }
+        });
+  }
+}
+
+// Implements mightContainBatch() for both filter classes: sets the result bit
+// of every non-empty key for which `testHash(digest)` is true.
+template <typename TestHash, typename Prefetch = NoPrefetch>
+uint32_t probeBatch(KeyHash keyHash, const KeyPrefix* const prefix, const char* const keys, const uint32_t* const offsets, uint32_t keyCount, uint8_t* const results,
+                    TestHash testHash, Prefetch prefetch = {}) {
+  // `results` may be null when there are no keys, e.g. an empty vector's data().
+  if (keyCount > 0) {
+    memset(results, 0, (keyCount + 7) / 8);
+  }
+
+  uint32_t positiveCount = 0;
+  forEachKeyHash(keyHash, prefix, keys, offsets, keyCount, [&](uint32_t i, const uint8_t* digest) {
+    if (testHash(digest)) {
+      results[i / 8] = static_cast<uint8_t>(results[i / 8] | (0x01 << (i % 8)));
+      positiveCount++;
+    }
+  }, prefetch);
+  return positiveCount;
+}
+
+typedef uint8_t BitmapVector __attribute__((vector_size(16)));
+
+// Applies `combine` to every byte of `bitmap` and the same byte of `other`, 16
+// bytes at a time where possible, which is a single SIMD instruction where the
+// target has 128-bit vectors.
+
+template <typename Combine>
+void combineBitmaps(std::vector<uint8_t>& bitmap, const std::vector<uint8_t>& other, Combine combine) {
+  const size_t length = bitmap.size();
+  size_t i = 0;
+  for (; i + sizeof(BitmapVector) <= length; i += sizeof(BitmapVector)) {
+    BitmapVector a;
+    BitmapVector b;
+    memcpy(&a, bitmap.data() + i, sizeof(a));
+    memcpy(&b, other.data() + i, sizeof(b));
+    a = combine(a, b);
+    memcpy(bitmap.data() + i, &a, sizeof(a));
+  }
+  for (; i < length; i++) {
+    bitmap[i] = static_cast<uint8_t>(combine(bitmap[i], other[i]));
+  }
+}
+
+} // namespace
+
+KeyPrefix::KeyPrefix(const char* const prefix, uint32_t prefixLength) : _prefix(prefix, prefix + prefixLength) {
+  MD5_Init(&_md5Context);
+  MD5_Update(&_md5Context, prefix, prefixLength);
+}
+
+BloomFilter::BloomFilter(const uint8_t* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount,
+                         IndexMapping indexMapping, KeyHash keyHash)
+    : BloomFilter(nullptr, bitmapLength, padding, hashCount, BitmapOwnership::Adopt, indexMapping, keyHash) {
+  WASMDEMO_STATS_TIMER(bloomCreateNanos);
+  _sparseBitmap = SparseBitmap::createIfSmaller(bitmap, _size);
+  if (!_sparseBitmap) {
+    _bitmap = static_cast<uint8_t*>(malloc(storageSizeFor(bitmapLength)));
+    memcpy(_bitmap, bitmap, bitmapLength);
+    clearStorageTail(_bitmap, bitmapLength);
+  }
+}
+
+BloomFilter::BloomFilter(uint8_t* bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount, BitmapOwnership ownership,
+                         IndexMapping indexMapping, KeyHash keyHash)
+    : _size(bitmapLength * 8 - padding), _bitmap(bitmap), _hashCount(hashCount),
+      _ownsBitmap(ownership == BitmapOwnership::Adopt), _indexMapping(indexMapping), _keyHash(keyHash),
+      _sizeModulo(sizeModuloFor(_size)),
+      _probeHash(probeHashFor(indexMapping, hashCount)),
+      _prefetchHash(indexMapping == IndexMapping::MultiplyShift ? prefetchKernel<IndexMapping::MultiplyShift>
+                                                                : prefetchKernel<IndexMapping::Modulo>) {
+  WASMDEMO_STATS_ADD(bloomFiltersCreated, 1);
+  WASMDEMO_STATS_TIMER(bloomCreateNanos);
+  if (_bitmap && _ownsBitmap) {
+    _sparseBitmap = SparseBitmap::createIfSmaller(_bitmap, _size);
+    if (_sparseBitmap) {
+      free(_bitmap);
+      _bitmap = nullptr;
+    }
+  }
 }
 
 BloomFilter::~BloomFilter(){
-  free(_bitmap);
+  if (_ownsBitmap) {
+    free(_bitmap);
+  }
+  delete _sparseBitmap;
+}
+
+uint32_t BloomFilter::storageSizeFor(uint32_t bitmapLength) {
+  return (bitmapLength + 7) & ~7u;
 }
 
 bool BloomFilter::mightContain(const char* const value, uint32_t valueLength) {
@@ -23,34 +292,572 @@ bool BloomFilter::mightContain(const char* const value, uint32_t valueLength) {
   }
 
   uint8_t outputHash[16];
-  MD5_CTX hashContext;
-  MD5_Init(&hashContext);
-  MD5_Update(&hashContext, value, valueLength);
-  MD5_Final(outputHash, &hashContext);
+  hashKey(_keyHash, value, valueLength, outputHash);
 
-  // Interpret the size 16 char array as a size 2 int64 array
-  auto* castOutputHash = reinterpret_cast<uint64_t*>(outputHash);
+  return mightContainHash(outputHash);
+}
 
-  uint64_t hash1 = castOutputHash[0];
-  uint64_t hash2 = castOutputHash[1];
+uint32_t BloomFilter::mightContainBatch(const char* const keys, const uint32_t* const offsets, uint32_t keyCount, uint8_t* const results) {
+  WASMDEMO_STATS_TIMER(bloomBatchProbeNanos);
+  if (_size == 0) {
+    if (keyCount > 0) {
+      memset(results, 0, (keyCount + 7) / 8);
+    }
+    return 0;
+  }
+  return probeBatch(_keyHash, nullptr, keys, offsets, keyCount, results,
+                    [this](const uint8_t* digest) { return mightContainHash(digest); },
+                    [this](const uint8_t* digest) { prefetchHash(digest); });
+}
 
-  for (uint32_t i = 0; i < _hashCount; i++) {
-    uint64_t index = getBitIndex(hash1, hash2, i);
-    if (!isBitSet(index)) {
-      return false;
+#if !WASMDEMO_MINIMAL
+uint32_t BloomFilter::mightContainBatch(const char* const keys, const uint32_t* const offsets, uint32_t keyCount, uint8_t* const results, ThreadPool& pool) {
+  // Every run but the last is a whole number of chunks, which also keeps the
+  // threads from writing to the same results byte.
+  const uint32_t chunkCount = (keyCount + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+  const uint32_t runCount = std::min(chunkCount, pool.threadCount() * PARALLEL_RUNS_PER_THREAD);
+  if (runCount <= 1) {
+    return mightContainBatch(keys, offsets, keyCount, results);
+  }
+  const uint32_t runKeyCount = (chunkCount + runCount - 1) / runCount * BATCH_CHUNK_SIZE;
+
+  std::vector<uint32_t> runPositiveCounts(runCount);
+  pool.parallelFor(runCount, [&](uint32_t run) {
+    const uint32_t runStart = std::min(keyCount, run * runKeyCount);
+    const uint32_t runSize = std::min(runKeyCount, keyCount - runStart);
+    // The offsets are relative to `keys`, not to the run's first key.
+    runPositiveCounts[run] = mightContainBatch(keys, offsets + runStart, runSize, results + runStart / 8);
+  });
+
+  uint32_t positiveCount = 0;
+  for (uint32_t runPositiveCount : runPositiveCounts) {
+    positiveCount += runPositiveCount;
+  }
+  return positiveCount;
+}
+#endif
+
+bool BloomFilter::mightContain(const KeyPrefix& prefix, const char* const suffix, uint32_t suffixLength) {
+  if (_size == 0 || prefix.length() + suffixLength == 0) {
+    return false;
+  }
+
+  uint8_t outputHash[16];
+  if (_keyHash == KeyHash::MD5) {
+    MD5_CTX hashContext = prefix.md5Context();
+    MD5_Update(&hashContext, suffix, suffixLength);
+    MD5_Final(outputHash, &hashContext);
+  } else {
+    std::vector<char> key;
+    assignPrefixedKey(key, prefix, suffix, suffixLength);
+    hashKey(_keyHash, key.data(), static_cast<uint32_t>(key.size()), outputHash);
+  }
+
+  return mightContainHash(outputHash);
+}
+
+uint32_t BloomFilter::mightContainBatch(const KeyPrefix& prefix, const char* const suffixes, const uint32_t* const offsets, uint32_t keyCount, uint8_t* const results) {
+  WASMDEMO_STATS_TIMER(bloomBatchProbeNanos);
+  if (_size == 0) {
+    if (keyCount > 0) {
+      memset(results, 0, (keyCount + 7) / 8);
+    }
+    return 0;
+  }
+  return probeBatch(_keyHash, &prefix, suffixes, offsets, keyCount, results,
+                    [this](const uint8_t* digest) { return mightContainHash(digest); },
+                    [this](const uint8_t* digest) { prefetchHash(digest); });
+}
+
+bool BloomFilter::mightContainHash(const uint8_t* const digest) {
+  const bool result = _probeHash(*this, digest);
+  WASMDEMO_STATS_ADD(bloomProbes, 1);
+  WASMDEMO_STATS_ADD(bloomPositives, result ? 1 : 0);
+  return result;
+}
+
+BloomFilter::ProbeHash BloomFilter::probeHashFor(IndexMapping indexMapping, uint32_t hashCount) {
+  // KERNELS[0] is the generic kernel, and KERNELS[k] the one for k hashes.
+  const auto select = [hashCount]<IndexMapping INDEX_MAPPING, uint32_t... FIXED_HASH_COUNTS>(
+                          std::integral_constant<IndexMapping, INDEX_MAPPING>,
+                          std::integer_sequence<uint32_t, FIXED_HASH_COUNTS...>) {
+    constexpr ProbeHash KERNELS[] = {probeHash<INDEX_MAPPING, FIXED_HASH_COUNTS>...};
+    return hashCount < std::size(KERNELS) ? KERNELS[hashCount] : KERNELS[0];
+  };
+  const auto fixedHashCounts = std::make_integer_sequence<uint32_t, MAX_SPECIALIZED_HASH_COUNT + 1>();
+
+  if (indexMapping == IndexMapping::MultiplyShift) {
+    return select(std::integral_constant<IndexMapping, IndexMapping::MultiplyShift>(), fixedHashCounts);
+  }
+  return select(std::integral_constant<IndexMapping, IndexMapping::Modulo>(), fixedHashCounts);
+}
+
+template <BloomFilter::IndexMapping INDEX_MAPPING, uint32_t FIXED_HASH_COUNT>
+bool BloomFilter::probeHash(const BloomFilter& filter, const uint8_t* const digest) {
+  uint64_t hash1;
+  uint64_t hash2;
+  memcpy(&hash1, digest, sizeof(hash1));
+  memcpy(&hash2, digest + sizeof(hash1), sizeof(hash2));
+
+  // Reduce each hashed value h(i) = h1 + (i * h2), in wrapping 64-bit
+  // arithmetic, independently, rather than stepping the index by h2 % size, so
+  // that the index computations do not form a dependency chain.
+  const auto bitIndex = [&filter](uint64_t hashValue) {
+    return bitIndexFor<INDEX_MAPPING>(hashValue, filter._size, filter._sizeModulo);
+  };
+
+  if constexpr (FIXED_HASH_COUNT == 0) {
+    uint64_t hashValue = hash1;
+    for (uint32_t i = 0; i < filter._hashCount; i++) {
+      if (!filter.isBitSet(bitIndex(hashValue))) {
+        WASMDEMO_STATS_ADD(bloomNegativeProbeDepths[std::min(i, BLOOM_PROBE_DEPTH_BUCKET_COUNT - 1)], 1);
+        return false;
+      }
+      hashValue += hash2;
+    }
+    return true;
+  } else {
+    // With the hash count known, the loop is fully unrolled.
+    for (uint32_t i = 0; i < FIXED_HASH_COUNT; i++) {
+      if (!filter.isBitSet(bitIndex(hash1 + i * hash2))) {
+        WASMDEMO_STATS_ADD(bloomNegativeProbeDepths[std::min(i, BLOOM_PROBE_DEPTH_BUCKET_COUNT - 1)], 1);
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+uint32_t BloomFilter::mightContainHashes(const uint8_t* const digests, uint32_t count, uint8_t* const results) {
+  WASMDEMO_STATS_TIMER(bloomBatchProbeNanos);
+  if (count == 0) {
+    return 0;
+  }
+  memset(results, 0, (count + 7) / 8);
+  if (_size == 0) {
+    return 0;
+  }
+
+  uint32_t positiveCount = 0;
+  pipelined(
+      count,
+      [this, digests](uint32_t i) { prefetchHash(digests + i * 16); },
+      [&](uint32_t i) {
+        if (mightContainHash(digests + i * 16)) {
+          results[i / 8] = static_cast<uint8_t>(results[i / 8] | (0x01 << (i % 8)));
+          positiveCount++;
+        }
+      });
+  return positiveCount;
+}
+
+template <BloomFilter::IndexMapping INDEX_MAPPING>
+void BloomFilter::prefetchKernel(const BloomFilter& filter, const uint8_t* const digest) {
+  if (!filter._bitmap || filter._size / 8 < PREFETCH_MIN_BITMAP_LENGTH) {
+    return;
+  }
+
+  uint64_t hash1;
+  uint64_t hash2;
+  memcpy(&hash1, digest, sizeof(hash1));
+  memcpy(&hash2, digest + sizeof(hash1), sizeof(hash2));
+
+  // Fetch every bit that mightContainHash() might test, not just the first:
+  // the point is for all of a key's misses to overlap. On targets without a
+  // prefetch instruction, such as wasm32, this compiles to nothing.
+  uint64_t hashValue = hash1;
+  for (uint32_t i = 0; i < filter._hashCount; i++) {
+    __builtin_prefetch(filter._bitmap + bitIndexFor<INDEX_MAPPING>(hashValue, filter._size, filter._sizeModulo) / 8);
+    hashValue += hash2;
+  }
+}
+
+size_t BloomFilter::memoryUsage() const {
+  if (_sparseBitmap) {
+    return _sparseBitmap->memoryUsage();
+  }
+  return _bitmap ? static_cast<size_t>((_size + 63) / 64 * 8) : 0;
+}
+
+uint64_t BloomFilter::setBitCount() const {
+  if (_sparseBitmap) {
+    return _sparseBitmap->setBitCount();
+  }
+
+  const uint64_t fullWordCount = _size / 64;
+  uint64_t count = 0;
+  for (uint64_t i = 0; i < fullWordCount; i++) {
+    count += static_cast<uint64_t>(std::popcount(loadWord(i)));
+  }
+
+  // Only count the bits of the last, partial word that are not padding.
+  const uint64_t remainingBitCount = _size % 64;
+  if (remainingBitCount != 0) {
+    uint64_t word = loadWord(fullWordCount);
+    if constexpr (std::endian::native == std::endian::big) {
+      word = __builtin_bswap64(word);
     }
+    count += static_cast<uint64_t>(std::popcount(word & ((uint64_t{1} << remainingBitCount) - 1)));
+  }
+  return count;
+}
+
+double BloomFilter::estimatedItemCount() const {
+  if (_size == 0 || _hashCount == 0) {
+    return 0;
+  }
+  const double size = static_cast<double>(_size);
+  return -size / _hashCount * std::log1p(-static_cast<double>(setBitCount()) / size);
+}
+
+double BloomFilter::estimatedFalsePositiveRate() const {
+  if (_size == 0) {
+    return 0;
+  }
+  return std::pow(static_cast<double>(setBitCount()) / static_cast<double>(_size), _hashCount);
+}
+
+uint64_t BloomFilter::loadWord(uint64_t wordIndex) const {
+  uint64_t word;
+  memcpy(&word, static_cast<const uint8_t*>(__builtin_assume_aligned(_bitmap, 8)) + wordIndex * 8, sizeof(word));
+  return word;
+}
+
+bool BloomFilter::isBitSet(uint64_t n) const {
+  if (_sparseBitmap) {
+    return _sparseBitmap->isBitSet(n);
+  }
+
+  // Bit n of the bitmap is bit n % 8 of byte n / 8, which is bit n % 64 of the
+  // word on little-endian machines; on big-endian ones, the bytes of the word
+  // are reversed.
+  const uint64_t bitInWord = std::endian::native == std::endian::big ? (n % 64) ^ 56 : n % 64;
+  return ((loadWord(n / 64) >> bitInWord) & 0x01) != 0;
+}
+
+BloomFilterBuilder::BloomFilterBuilder(uint32_t bitCount, uint32_t hashCount, BloomFilter::IndexMapping indexMapping,
+                                       KeyHash keyHash)
+    : _bitmap(BloomFilter::storageSizeFor(static_cast<uint32_t>((static_cast<uint64_t>(bitCount) + 7) / 8))),
+      _size(bitCount), _hashCount(hashCount),
+      _indexMapping(indexMapping), _keyHash(keyHash),
+      _sizeModulo(sizeModuloFor(bitCount)) {
+}
+
+uint32_t BloomFilterBuilder::bitCountFor(uint64_t expectedItemCount, double falsePositiveRate) {
+  // m = -n ln(p) / ln(2)^2, rounded up.
+  const double ln2 = std::log(2.0);
+  const double bitCount = std::ceil(-static_cast<double>(expectedItemCount) * std::log(falsePositiveRate) / (ln2 * ln2));
+  if (!(bitCount >= 1)) {
+    return 1;
+  }
+  return bitCount >= INT32_MAX ? INT32_MAX : static_cast<uint32_t>(bitCount);
+}
+
+uint32_t BloomFilterBuilder::hashCountFor(uint32_t bitCount, uint64_t expectedItemCount) {
+  // k = m / n ln(2), rounded to the nearest integer.
+  if (expectedItemCount == 0) {
+    return 1;
+  }
+  const double hashCount = std::round(static_cast<double>(bitCount) / static_cast<double>(expectedItemCount) * std::log(2.0));
+  if (!(hashCount >= 1)) {
+    return 1;
+  }
+  return hashCount >= MAX_HASH_COUNT ? MAX_HASH_COUNT : static_cast<uint32_t>(hashCount);
+}
+
+void BloomFilterBuilder::insert(const char* const value, uint32_t valueLength) {
+  if (_size == 0 || valueLength == 0) {
+    return;
+  }
+
+  uint8_t outputHash[16];
+  hashKey(_keyHash, value, valueLength, outputHash);
+  insertHash(outputHash);
+}
+
+void BloomFilterBuilder::insertBatch(const char* const keys, const uint32_t* const offsets, uint32_t keyCount) {
+  if (_size == 0) {
+    return;
   }
+  forEachKeyHash(_keyHash, nullptr, keys, offsets, keyCount, [this](uint32_t, const uint8_t* digest) {
+    insertHash(digest);
+  });
+}
+
+bool BloomFilterBuilder::unionWith(const BloomFilterBuilder& other) {
+  if (!isCompatibleWith(other)) {
+    return false;
+  }
+  combineBitmaps(_bitmap, other._bitmap, [](auto a, auto b) { return a | b; });
+  return true;
+}
+
+bool BloomFilterBuilder::intersectWith(const BloomFilterBuilder& other) {
+  if (!isCompatibleWith(other)) {
+    return false;
+  }
+  combineBitmaps(_bitmap, other._bitmap, [](auto a, auto b) { return a & b; });
   return true;
 }
 
-uint64_t BloomFilter::getBitIndex(uint64_t num1, uint64_t num2, uint64_t index) {
-  // Calculate hashed value h(i) = h1 + (i * h2).
-  uint64_t hashValue = num1 + (num2 * index);
-  return hashValue % _size;
+BloomFilter* BloomFilterBuilder::build() const {
+  return new BloomFilter(_bitmap.data(), bitmapLength(), padding(), _hashCount, _indexMapping, _keyHash);
+}
+
+#if !WASMDEMO_MINIMAL
+std::string BloomFilterBuilder::toJson() const {
+  std::string json = "{ \"bits\": { \"bitmap\": \"" + base64_encode(_bitmap.data(), bitmapLength())
+      + "\", \"padding\": " + std::to_string(padding())
+      + " }, \"hashCount\": " + std::to_string(_hashCount);
+  if (_keyHash != KeyHash::MD5) {
+    json += ", \"keyHash\": " + std::to_string(static_cast<int>(_keyHash));
+  }
+  if (_indexMapping != BloomFilter::IndexMapping::Modulo) {
+    json += ", \"indexMapping\": " + std::to_string(static_cast<int>(_indexMapping));
+  }
+  return json + " }";
+}
+#endif
+
+void BloomFilterBuilder::insertHash(const uint8_t* const digest) {
+  // Set the bits that BloomFilter::mightContainHash() tests.
+  uint64_t hash1;
+  uint64_t hash2;
+  memcpy(&hash1, digest, sizeof(hash1));
+  memcpy(&hash2, digest + sizeof(hash1), sizeof(hash2));
+
+  uint64_t hashValue = hash1;
+  for (uint32_t i = 0; i < _hashCount; i++) {
+    const uint64_t n = bitIndexFor(_indexMapping, hashValue, _size, _sizeModulo);
+    _bitmap[n / 8] = static_cast<uint8_t>(_bitmap[n / 8] | (0x01 << (n % 8)));
+    hashValue += hash2;
+  }
+}
+
+bool BloomFilterBuilder::isCompatibleWith(const BloomFilterBuilder& other) const {
+  return _size == other._size && _hashCount == other._hashCount
+      && _indexMapping == other._indexMapping && _keyHash == other._keyHash;
+}
+
+namespace {
+
+typedef uint32_t BlockWords __attribute__((vector_size(BlockedBloomFilter::BLOCK_SIZE)));
+typedef uint64_t BlockQuadWords __attribute__((vector_size(BlockedBloomFilter::BLOCK_SIZE)));
+
+// The salts from the Parquet split block bloom filter specification.
+const BlockWords BLOCK_SALTS = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+const uint8_t BLOCKED_MAGIC[4] = {'W', 'B', 'B', 'F'};
+const uint8_t BLOCKED_FORMAT_VERSION = 1;
+
+// The number of 32-bit words in a block.
+const uint32_t BLOCK_WORD_COUNT = BlockedBloomFilter::BLOCK_SIZE / 4;
+
+// Returns uninitialized storage for the given number of blocks, or null if
+// there is not enough memory (or there are no blocks).
+uint32_t* allocateBlocks(uint32_t blockCount) {
+  return static_cast<uint32_t*>(aligned_alloc(BlockedBloomFilter::BLOCK_SIZE, static_cast<size_t>(blockCount) * BlockedBloomFilter::BLOCK_SIZE));
 }
 
-bool BloomFilter::isBitSet(uint64_t n) {
-  return (_bitmap[n / 8] & (0x01 << (n % 8))) != 0;
+// Sets `mask` to the bit that a key sets in each word of its block.
+void blockMask(uint32_t key, BlockWords& mask) {
+  mask = (BlockWords{} + 1) << ((BLOCK_SALTS * key) >> 27);
+}
+
+// Returns the expected false positive rate of a BlockedBloomFilter with the
+// given number of blocks after inserting the given number of items. The number
+// of items in a block is Poisson distributed, and a block with j items has a
+// false positive rate of (1 - (1 - 1/32)^j)^8, since each item sets one of the
+// 32 bits of each of the 8 words of the block.
+double falsePositiveRateFor(uint64_t itemCount, uint32_t blockCount) {
+  const double itemsPerBlock = static_cast<double>(itemCount) / blockCount;
+  if (itemsPerBlock == 0) {
+    return 0;
+  }
+
+  // Sum the terms within a generous number of standard deviations of the mean.
+  const double spread = 10 * std::sqrt(itemsPerBlock) + 10;
+  const double first = std::max(0.0, std::floor(itemsPerBlock - spread));
+  const double last = std::ceil(itemsPerBlock + spread);
+  const double wordBitUnsetRate = 1.0 - 1.0 / 32;
+  double rate = 0;
+  for (double j = first; j <= last; j++) {
+    const double logProbability = j * std::log(itemsPerBlock) - itemsPerBlock - std::lgamma(j + 1);
+    rate += std::exp(logProbability) * std::pow(1.0 - std::pow(wordBitUnsetRate, j), BLOCK_WORD_COUNT);
+  }
+  return rate;
+}
+
+uint64_t lowerHash64(const uint8_t* digest) {
+  uint64_t hash;
+  memcpy(&hash, digest, sizeof(hash));
+  return hash;
+}
+
+void writeUint32(uint8_t* dest, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    dest[i] = static_cast<uint8_t>(value >> (i * 8));
+  }
+}
+
+uint32_t readUint32(const uint8_t* src) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= static_cast<uint32_t>(src[i]) << (i * 8);
+  }
+  return value;
+}
+
+} // namespace
+
+BlockedBloomFilter::BlockedBloomFilter(uint32_t blockCount, uint32_t* blocks, KeyHash keyHash)
+    : _blockCount(blockCount), _blocks(blocks), _keyHash(keyHash) {
+}
+
+BlockedBloomFilter::~BlockedBloomFilter() {
+  free(_blocks);
+}
+
+uint32_t BlockedBloomFilter::blockCountFor(uint64_t expectedItemCount, double falsePositiveRate) {
+  // Double the block count until the filter is accurate enough, then binary
+  // search for the smallest accurate block count.
+  const uint32_t maxBlockCount = UINT32_MAX / BLOCK_SIZE;
+  uint32_t lower = 0;
+  uint32_t upper = 1;
+  while (upper < maxBlockCount && falsePositiveRateFor(expectedItemCount, upper) > falsePositiveRate) {
+    lower = upper;
+    upper = upper > maxBlockCount / 2 ? maxBlockCount : upper * 2;
+  }
+  while (upper - lower > 1) {
+    const uint32_t middle = lower + (upper - lower) / 2;
+    if (falsePositiveRateFor(expectedItemCount, middle) > falsePositiveRate) {
+      lower = middle;
+    } else {
+      upper = middle;
+    }
+  }
+  return upper;
+}
+
+BlockedBloomFilter* BlockedBloomFilter::create(uint32_t blockCount, KeyHash keyHash) {
+  uint32_t* const blocks = allocateBlocks(blockCount);
+  if (!blocks && blockCount > 0) {
+    return nullptr;
+  }
+  if (blockCount > 0) {
+    memset(blocks, 0, static_cast<size_t>(blockCount) * BLOCK_SIZE);
+  }
+  return new BlockedBloomFilter(blockCount, blocks, keyHash);
+}
+
+BlockedBloomFilter* BlockedBloomFilter::deserialize(const uint8_t* data, uint32_t length) {
+  if (length < HEADER_SIZE
+      || memcmp(data, BLOCKED_MAGIC, sizeof(BLOCKED_MAGIC)) != 0
+      || data[4] != BLOCKED_FORMAT_VERSION
+      || !isKnownKeyHash(data[5])) {
+    return nullptr;
+  }
+
+  const uint32_t blockCount = readUint32(data + 8);
+  if (static_cast<uint64_t>(blockCount) * BLOCK_SIZE != length - HEADER_SIZE) {
+    return nullptr;
+  }
+
+  // The block count comes from the data, so it may well be too large to
+  // allocate, particularly in a 32-bit address space.
+  uint32_t* const blocks = allocateBlocks(blockCount);
+  if (!blocks && blockCount > 0) {
+    return nullptr;
+  }
+
+  auto* filter = new BlockedBloomFilter(blockCount, blocks, static_cast<KeyHash>(data[5]));
+  const uint8_t* src = data + HEADER_SIZE;
+  for (uint64_t i = 0; i < static_cast<uint64_t>(blockCount) * BLOCK_WORD_COUNT; i++) {
+    filter->_blocks[i] = readUint32(src + i * 4);
+  }
+  return filter;
+}
+
+uint32_t BlockedBloomFilter::serializedSize() const {
+  return HEADER_SIZE + _blockCount * BLOCK_SIZE;
+}
+
+void BlockedBloomFilter::serialize(uint8_t* dest) const {
+  memcpy(dest, BLOCKED_MAGIC, sizeof(BLOCKED_MAGIC));
+  dest[4] = BLOCKED_FORMAT_VERSION;
+  dest[5] = static_cast<uint8_t>(_keyHash);
+  dest[6] = 0;
+  dest[7] = 0;
+  writeUint32(dest + 8, _blockCount);
+
+  uint8_t* out = dest + HEADER_SIZE;
+  for (uint64_t i = 0; i < static_cast<uint64_t>(_blockCount) * BLOCK_WORD_COUNT; i++) {
+    writeUint32(out + i * 4, _blocks[i]);
+  }
+}
+
+void BlockedBloomFilter::insert(const char* const value, uint32_t valueLength) {
+  if (_blockCount == 0 || valueLength == 0) {
+    return;
+  }
+
+  uint8_t outputHash[16];
+  hashKey(_keyHash, value, valueLength, outputHash);
+  insertHash(outputHash);
+}
+
+bool BlockedBloomFilter::mightContain(const char* const value, uint32_t valueLength) const {
+  if (_blockCount == 0 || valueLength == 0) {
+    return false;
+  }
+
+  uint8_t outputHash[16];
+  hashKey(_keyHash, value, valueLength, outputHash);
+  return mightContainHash(outputHash);
+}
+
+uint32_t BlockedBloomFilter::mightContainBatch(const char* const keys, const uint32_t* const offsets, uint32_t keyCount, uint8_t* const results) const {
+  if (_blockCount == 0) {
+    if (keyCount > 0) {
+      memset(results, 0, (keyCount + 7) / 8);
+    }
+    return 0;
+  }
+  return probeBatch(_keyHash, nullptr, keys, offsets, keyCount, results,
+                    [this](const uint8_t* digest) { return mightContainHash(digest); });
+}
+
+void BlockedBloomFilter::insertHash(const uint8_t* const digest) {
+  const uint64_t hash = lowerHash64(digest);
+  uint32_t* const blockWords = blockForHash(hash);
+
+  BlockWords mask;
+  blockMask(static_cast<uint32_t>(hash), mask);
+  BlockWords block;
+  memcpy(&block, blockWords, BLOCK_SIZE);
+  block |= mask;
+  memcpy(blockWords, &block, BLOCK_SIZE);
+}
+
+bool BlockedBloomFilter::mightContainHash(const uint8_t* const digest) const {
+  const uint64_t hash = lowerHash64(digest);
+
+  BlockWords mask;
+  blockMask(static_cast<uint32_t>(hash), mask);
+  BlockWords block;
+  memcpy(&block, blockForHash(hash), BLOCK_SIZE);
+
+  // The key might be contained if none of its bits are missing from the block.
+  const auto missing = reinterpret_cast<BlockQuadWords>(mask & ~block);
+  return (missing[0] | missing[1] | missing[2] | missing[3]) == 0;
+}
+
+uint32_t* BlockedBloomFilter::blockForHash(uint64_t hash) const {
+  // Map the upper 32 bits of the hash onto [0, _blockCount) without a division.
+  const uint64_t blockIndex = ((hash >> 32) * _blockCount) >> 32;
+  return _blocks + blockIndex * BLOCK_WORD_COUNT;
 }
 
 /// bloom filter code ends here
@@ -63,12 +870,278 @@ BloomFilter* newBloomFilter(const int8_t* bitmap, int32_t bitmapLength, int32_t
                          static_cast<uint32_t>(hashCount));
 }
 
+WASM_EXPORT("allocBloomFilterBitmap")
+uint8_t* allocBloomFilterBitmap(int32_t bitmapLength) {
+  if (bitmapLength < 0) {
+    abort();
+  }
+  auto* const bitmap = static_cast<uint8_t*>(malloc(BloomFilter::storageSizeFor(static_cast<uint32_t>(bitmapLength))));
+  if (bitmap) {
+    clearStorageTail(bitmap, static_cast<uint32_t>(bitmapLength));
+  }
+  return bitmap;
+}
+
+WASM_EXPORT("newBloomFilterAdoptingBitmap")
+BloomFilter* newBloomFilterAdoptingBitmap(uint8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount) {
+  return newBloomFilterAdoptingBitmapWithOptions(bitmap, bitmapLength, padding, hashCount,
+                                                 static_cast<int32_t>(BloomFilter::IndexMapping::Modulo), static_cast<int32_t>(KeyHash::MD5));
+}
+
+WASM_EXPORT("newBloomFilterAdoptingBitmapWithOptions")
+BloomFilter* newBloomFilterAdoptingBitmapWithOptions(uint8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount,
+                                                     int32_t indexMapping, int32_t keyHash) {
+  if (!isKnownIndexMapping(static_cast<uint32_t>(indexMapping)) || !isKnownKeyHash(static_cast<uint32_t>(keyHash))) {
+    abort();
+  }
+  return new BloomFilter(bitmap,
+                         static_cast<uint32_t>(bitmapLength),
+                         static_cast<uint32_t>(padding),
+                         static_cast<uint32_t>(hashCount),
+                         BloomFilter::BitmapOwnership::Adopt,
+                         static_cast<BloomFilter::IndexMapping>(indexMapping),
+                         static_cast<KeyHash>(keyHash));
+}
+
+WASM_EXPORT("newBloomFilterBorrowingBitmap")
+BloomFilter* newBloomFilterBorrowingBitmap(const uint8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount) {
+  // The filter never writes to a bitmap that it does not own.
+  return new BloomFilter(const_cast<uint8_t*>(bitmap),
+                         static_cast<uint32_t>(bitmapLength),
+                         static_cast<uint32_t>(padding),
+                         static_cast<uint32_t>(hashCount),
+                         BloomFilter::BitmapOwnership::Borrow);
+}
+
+WASM_EXPORT("newBloomFilterFromBase64")
+BloomFilter* newBloomFilterFromBase64(const char* base64Bitmap, int32_t base64BitmapLength, int32_t padding, int32_t hashCount) {
+  return newBloomFilterFromBase64WithOptions(base64Bitmap, base64BitmapLength, padding, hashCount,
+                                             static_cast<int32_t>(BloomFilter::IndexMapping::Modulo), static_cast<int32_t>(KeyHash::MD5));
+}
+
+WASM_EXPORT("newBloomFilterFromBase64WithOptions")
+BloomFilter* newBloomFilterFromBase64WithOptions(const char* base64Bitmap, int32_t base64BitmapLength, int32_t padding, int32_t hashCount,
+                                                 int32_t indexMapping, int32_t keyHash) {
+  if (base64BitmapLength < 0
+      || !isKnownIndexMapping(static_cast<uint32_t>(indexMapping))
+      || !isKnownKeyHash(static_cast<uint32_t>(keyHash))) {
+    abort();
+  }
+  const std::string_view encodedBitmap(base64Bitmap, static_cast<size_t>(base64BitmapLength));
+  const auto decodedSize = static_cast<uint32_t>(base64_decoded_size(encodedBitmap));
+  // The size comes from the server, so it may well be too large to allocate.
+  auto* bitmap = static_cast<uint8_t*>(malloc(BloomFilter::storageSizeFor(decodedSize)));
+  if (!bitmap) {
+    return nullptr;
+  }
+  size_t bitmapLength;
+  {
+    WASMDEMO_STATS_TIMER(base64DecodeNanos);
+    bitmapLength = base64_decode_into(encodedBitmap, bitmap);
+  }
+  clearStorageTail(bitmap, static_cast<uint32_t>(bitmapLength));
+  auto* const filter = new BloomFilter(bitmap,
+                                       static_cast<uint32_t>(bitmapLength),
+                                       static_cast<uint32_t>(padding),
+                                       static_cast<uint32_t>(hashCount),
+                                       BloomFilter::BitmapOwnership::Adopt,
+                                       static_cast<BloomFilter::IndexMapping>(indexMapping),
+                                       static_cast<KeyHash>(keyHash));
+  WASMDEMO_LOG(Debug, LogLine() << "newBloomFilterFromBase64WithOptions: " << bitmapLength << " byte bitmap, hashCount "
+                                << hashCount << ", " << filter->memoryUsage() << " bytes in memory");
+  return filter;
+}
+
 WASM_EXPORT("deleteBloomFilter")
 void deleteBloomFilter(BloomFilter* instance) {
   delete instance;
 }
 
+WASM_EXPORT("newBloomFilterBuilder")
+BloomFilterBuilder* newBloomFilterBuilder(int32_t expectedItemCount, double falsePositiveRate) {
+  return newBloomFilterBuilderWithOptions(expectedItemCount, falsePositiveRate,
+                                          static_cast<int32_t>(BloomFilter::IndexMapping::Modulo), static_cast<int32_t>(KeyHash::MD5));
+}
+
+WASM_EXPORT("newBloomFilterBuilderWithOptions")
+BloomFilterBuilder* newBloomFilterBuilderWithOptions(int32_t expectedItemCount, double falsePositiveRate,
+                                                     int32_t indexMapping, int32_t keyHash) {
+  // Also rejects NaN.
+  if (expectedItemCount < 0
+      || !(falsePositiveRate > 0 && falsePositiveRate < 1)
+      || !isKnownIndexMapping(static_cast<uint32_t>(indexMapping))
+      || !isKnownKeyHash(static_cast<uint32_t>(keyHash))) {
+    abort();
+  }
+  const uint64_t itemCount = static_cast<uint64_t>(expectedItemCount);
+  const uint32_t bitCount = BloomFilterBuilder::bitCountFor(itemCount, falsePositiveRate);
+  return new BloomFilterBuilder(bitCount, BloomFilterBuilder::hashCountFor(bitCount, itemCount),
+                                static_cast<BloomFilter::IndexMapping>(indexMapping), static_cast<KeyHash>(keyHash));
+}
+
+WASM_EXPORT("deleteBloomFilterBuilder")
+void deleteBloomFilterBuilder(BloomFilterBuilder* instance) {
+  delete instance;
+}
+
+WASM_EXPORT("bloomFilterBuilderInsert")
+void bloomFilterBuilderInsert(BloomFilterBuilder* builder, const char* value, int32_t valueLength) {
+  if (valueLength < 0) {
+    abort();
+  }
+  builder->insert(value, static_cast<uint32_t>(valueLength));
+}
+
+WASM_EXPORT("bloomFilterBuilderInsertBatch")
+void bloomFilterBuilderInsertBatch(BloomFilterBuilder* builder, const char* keys, const int32_t* offsets, int32_t keyCount) {
+  if (keyCount < 0) {
+    abort();
+  }
+  builder->insertBatch(keys, reinterpret_cast<const uint32_t*>(offsets), static_cast<uint32_t>(keyCount));
+}
+
+WASM_EXPORT("bloomFilterBuilderUnion")
+bool bloomFilterBuilderUnion(BloomFilterBuilder* builder, const BloomFilterBuilder* other) {
+  return builder->unionWith(*other);
+}
+
+WASM_EXPORT("bloomFilterBuilderIntersect")
+bool bloomFilterBuilderIntersect(BloomFilterBuilder* builder, const BloomFilterBuilder* other) {
+  return builder->intersectWith(*other);
+}
+
+WASM_EXPORT("bloomFilterBuilderBuild")
+BloomFilter* bloomFilterBuilderBuild(const BloomFilterBuilder* builder) {
+  return builder->build();
+}
+
+WASM_EXPORT("bloomFilterBuilderBitmap")
+const uint8_t* bloomFilterBuilderBitmap(const BloomFilterBuilder* builder) {
+  return builder->bitmap();
+}
+
+WASM_EXPORT("bloomFilterBuilderBitmapLength")
+int32_t bloomFilterBuilderBitmapLength(const BloomFilterBuilder* builder) {
+  return static_cast<int32_t>(builder->bitmapLength());
+}
+
+WASM_EXPORT("bloomFilterBuilderPadding")
+int32_t bloomFilterBuilderPadding(const BloomFilterBuilder* builder) {
+  return static_cast<int32_t>(builder->padding());
+}
+
+WASM_EXPORT("bloomFilterBuilderHashCount")
+int32_t bloomFilterBuilderHashCount(const BloomFilterBuilder* builder) {
+  return static_cast<int32_t>(builder->hashCount());
+}
+
 WASM_EXPORT("mightContain")
 bool mightContain(BloomFilter* filter, char const* value, int32_t valueLength) {
   return filter->mightContain(value, static_cast<uint32_t>(valueLength));
 }
+
+WASM_EXPORT("bloomFilterSetBitCount")
+int32_t bloomFilterSetBitCount(const BloomFilter* filter) {
+  return static_cast<int32_t>(filter->setBitCount());
+}
+
+WASM_EXPORT("bloomFilterEstimatedItemCount")
+double bloomFilterEstimatedItemCount(const BloomFilter* filter) {
+  return filter->estimatedItemCount();
+}
+
+WASM_EXPORT("bloomFilterEstimatedFalsePositiveRate")
+double bloomFilterEstimatedFalsePositiveRate(const BloomFilter* filter) {
+  return filter->estimatedFalsePositiveRate();
+}
+
+WASM_EXPORT("mightContainBatch")
+int32_t mightContainBatch(BloomFilter* filter, const char* keys, const int32_t* offsets, int32_t keyCount, uint8_t* results) {
+  if (keyCount < 0) {
+    abort();
+  }
+  return static_cast<int32_t>(filter->mightContainBatch(keys,
+                                                        reinterpret_cast<const uint32_t*>(offsets),
+                                                        static_cast<uint32_t>(keyCount),
+                                                        results));
+}
+
+#if !WASMDEMO_MINIMAL
+WASM_EXPORT("mightContainBatchParallel")
+int32_t mightContainBatchParallel(BloomFilter* filter, const char* keys, const int32_t* offsets, int32_t keyCount, uint8_t* results, int32_t threadCount) {
+  if (keyCount < 0 || threadCount < 0) {
+    abort();
+  }
+  uint32_t positiveCount = 0;
+  withSharedThreadPool(static_cast<uint32_t>(threadCount), [&](ThreadPool& pool) {
+    positiveCount = filter->mightContainBatch(keys,
+                                              reinterpret_cast<const uint32_t*>(offsets),
+                                              static_cast<uint32_t>(keyCount),
+                                              results,
+                                              pool);
+  });
+  return static_cast<int32_t>(positiveCount);
+}
+#endif
+
+WASM_EXPORT("newKeyPrefix")
+KeyPrefix* newKeyPrefix(const char* prefix, int32_t prefixLength) {
+  if (prefixLength < 0) {
+    abort();
+  }
+  return new KeyPrefix(prefix, static_cast<uint32_t>(prefixLength));
+}
+
+WASM_EXPORT("deleteKeyPrefix")
+void deleteKeyPrefix(KeyPrefix* instance) {
+  delete instance;
+}
+
+WASM_EXPORT("mightContainWithPrefix")
+bool mightContainWithPrefix(BloomFilter* filter, const KeyPrefix* prefix, const char* suffix, int32_t suffixLength) {
+  if (suffixLength < 0) {
+    abort();
+  }
+  return filter->mightContain(*prefix, suffix, static_cast<uint32_t>(suffixLength));
+}
+
+WASM_EXPORT("mightContainBatchWithPrefix")
+int32_t mightContainBatchWithPrefix(BloomFilter* filter, const KeyPrefix* prefix, const char* suffixes, const int32_t* offsets, int32_t keyCount, uint8_t* results) {
+  if (keyCount < 0) {
+    abort();
+  }
+  return static_cast<int32_t>(filter->mightContainBatch(*prefix,
+                                                        suffixes,
+                                                        reinterpret_cast<const uint32_t*>(offsets),
+                                                        static_cast<uint32_t>(keyCount),
+                                                        results));
+}
+
+WASM_EXPORT("newBlockedBloomFilter")
+BlockedBloomFilter* newBlockedBloomFilter(const uint8_t* data, int32_t length) {
+  if (length < 0) {
+    abort();
+  }
+  return BlockedBloomFilter::deserialize(data, static_cast<uint32_t>(length));
+}
+
+WASM_EXPORT("deleteBlockedBloomFilter")
+void deleteBlockedBloomFilter(BlockedBloomFilter* instance) {
+  delete instance;
+}
+
+WASM_EXPORT("blockedBloomFilterMightContain")
+bool blockedBloomFilterMightContain(BlockedBloomFilter* filter, const char* value, int32_t valueLength) {
+  return filter->mightContain(value, static_cast<uint32_t>(valueLength));
+}
+
+WASM_EXPORT("blockedBloomFilterMightContainBatch")
+int32_t blockedBloomFilterMightContainBatch(BlockedBloomFilter* filter, const char* keys, const int32_t* offsets, int32_t keyCount, uint8_t* results) {
+  if (keyCount < 0) {
+    abort();
+  }
+  return static_cast<int32_t>(filter->mightContainBatch(keys,
+                                                        reinterpret_cast<const uint32_t*>(offsets),
+                                                        static_cast<uint32_t>(keyCount),
+                                                        results));
+}
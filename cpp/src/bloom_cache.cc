@@ -0,0 +1,194 @@
+#include <cstdlib>
+
+#include "wasmdemo/bloom_cache.h"
+#include "wasmdemo/xxh3.h"
+
+BloomFilterCache::BloomFilterCache(size_t maxBytes) : _maxBytes(maxBytes) {
+}
+
+BloomFilterCache::~BloomFilterCache() {
+  for (Entry& entry : _entries) {
+    delete entry.filter;
+  }
+}
+
+BloomFilter* BloomFilterCache::lookup(const uint8_t* const bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount) {
+  return lookup(keyFor(bitmap, bitmapLength, padding, hashCount, Encoding::Raw));
+}
+
+BloomFilter* BloomFilterCache::insert(const uint8_t* const bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount) {
+  return insert(keyFor(bitmap, bitmapLength, padding, hashCount, Encoding::Raw), [=]() {
+    return new BloomFilter(bitmap, bitmapLength, padding, hashCount);
+  });
+}
+
+BloomFilter* BloomFilterCache::lookupBase64(const char* const base64Bitmap, uint32_t base64BitmapLength, uint32_t padding, uint32_t hashCount) {
+  return lookup(keyFor(base64Bitmap, base64BitmapLength, padding, hashCount, Encoding::Base64));
+}
+
+BloomFilter* BloomFilterCache::insertBase64(const char* const base64Bitmap, uint32_t base64BitmapLength, uint32_t padding, uint32_t hashCount) {
+  return insert(keyFor(base64Bitmap, base64BitmapLength, padding, hashCount, Encoding::Base64), [=]() {
+    return newBloomFilterFromBase64(base64Bitmap,
+                                    static_cast<int32_t>(base64BitmapLength),
+                                    static_cast<int32_t>(padding),
+                                    static_cast<int32_t>(hashCount));
+  });
+}
+
+void BloomFilterCache::release(BloomFilter* filter) {
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+  const auto found = _entriesByFilter.find(filter);
+  if (found == _entriesByFilter.end() || found->second->referenceCount == 0) {
+    // Not a filter from this cache, or released too many times.
+    abort();
+  }
+  found->second->referenceCount--;
+  evict();
+}
+
+size_t BloomFilterCache::filterCount() const {
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+  return _entries.size();
+}
+
+size_t BloomFilterCache::memoryUsage() const {
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+  return _memoryUsage;
+}
+
+BloomFilterCache::Key BloomFilterCache::keyFor(const void* const bitmap, uint32_t bitmapLength, uint32_t padding, uint32_t hashCount,
+                                               Encoding encoding) {
+  const Xxh3Hash128 digest = xxh3Hash128(bitmap, bitmapLength);
+  return Key {digest.low64, digest.high64, bitmapLength, padding, hashCount, encoding};
+}
+
+BloomFilter* BloomFilterCache::lookup(const Key& key) {
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+  return acquire(key);
+}
+
+template <typename Create>
+BloomFilter* BloomFilterCache::insert(const Key& key, Create create) {
+  if (BloomFilter* filter = lookup(key)) {
+    return filter;
+  }
+
+  // Create the filter without holding the lock, since that takes a while.
+  BloomFilter* filter = create();
+  if (!filter) {
+    return nullptr;
+  }
+  const size_t memoryUsage = filter->memoryUsage();
+
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(_mutex);
+#endif
+  // Another thread may have inserted the same filter in the meantime.
+  if (BloomFilter* existingFilter = acquire(key)) {
+    delete filter;
+    return existingFilter;
+  }
+  _entries.push_front(Entry {key, filter, memoryUsage, 1});
+  _entriesByKey.emplace(key, _entries.begin());
+  _entriesByFilter.emplace(filter, _entries.begin());
+  _memoryUsage += memoryUsage;
+  evict();
+  return filter;
+}
+
+BloomFilter* BloomFilterCache::acquire(const Key& key) {
+  const auto found = _entriesByKey.find(key);
+  if (found == _entriesByKey.end()) {
+    return nullptr;
+  }
+  const EntryIterator entry = found->second;
+  entry->referenceCount++;
+  // Moving the entry to the front keeps every iterator to it valid.
+  _entries.splice(_entries.begin(), _entries, entry);
+  return entry->filter;
+}
+
+void BloomFilterCache::evict() {
+  auto entry = _entries.end();
+  while (_memoryUsage > _maxBytes && entry != _entries.begin()) {
+    --entry;
+    if (entry->referenceCount != 0) {
+      continue;
+    }
+    _memoryUsage -= entry->memoryUsage;
+    _entriesByKey.erase(entry->key);
+    _entriesByFilter.erase(entry->filter);
+    delete entry->filter;
+    entry = _entries.erase(entry);
+  }
+}
+
+WASM_EXPORT("newBloomFilterCache")
+BloomFilterCache* newBloomFilterCache(int32_t maxBytes) {
+  if (maxBytes < 0) {
+    abort();
+  }
+  return new BloomFilterCache(static_cast<size_t>(maxBytes));
+}
+
+WASM_EXPORT("deleteBloomFilterCache")
+void deleteBloomFilterCache(BloomFilterCache* cache) {
+  delete cache;
+}
+
+WASM_EXPORT("bloomFilterCacheLookup")
+BloomFilter* bloomFilterCacheLookup(BloomFilterCache* cache, const int8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount) {
+  if (bitmapLength < 0) {
+    abort();
+  }
+  return cache->lookup(reinterpret_cast<const uint8_t*>(bitmap),
+                       static_cast<uint32_t>(bitmapLength),
+                       static_cast<uint32_t>(padding),
+                       static_cast<uint32_t>(hashCount));
+}
+
+WASM_EXPORT("bloomFilterCacheInsert")
+BloomFilter* bloomFilterCacheInsert(BloomFilterCache* cache, const int8_t* bitmap, int32_t bitmapLength, int32_t padding, int32_t hashCount) {
+  if (bitmapLength < 0) {
+    abort();
+  }
+  return cache->insert(reinterpret_cast<const uint8_t*>(bitmap),
+                       static_cast<uint32_t>(bitmapLength),
+                       static_cast<uint32_t>(padding),
+                       static_cast<uint32_t>(hashCount));
+}
+
+WASM_EXPORT("bloomFilterCacheLookupBase64")
+BloomFilter* bloomFilterCacheLookupBase64(BloomFilterCache* cache, const char* base64Bitmap, int32_t base64BitmapLength, int32_t padding, int32_t hashCount) {
+  if (base64BitmapLength < 0) {
+    abort();
+  }
+  return cache->lookupBase64(base64Bitmap,
+                             static_cast<uint32_t>(base64BitmapLength),
+                             static_cast<uint32_t>(padding),
+                             static_cast<uint32_t>(hashCount));
+}
+
+WASM_EXPORT("bloomFilterCacheInsertBase64")
+BloomFilter* bloomFilterCacheInsertBase64(BloomFilterCache* cache, const char* base64Bitmap, int32_t base64BitmapLength, int32_t padding, int32_t hashCount) {
+  if (base64BitmapLength < 0) {
+    abort();
+  }
+  return cache->insertBase64(base64Bitmap,
+                             static_cast<uint32_t>(base64BitmapLength),
+                             static_cast<uint32_t>(padding),
+                             static_cast<uint32_t>(hashCount));
+}
+
+WASM_EXPORT("bloomFilterCacheRelease")
+void bloomFilterCacheRelease(BloomFilterCache* cache, BloomFilter* filter) {
+  cache->release(filter);
+}
@@ -0,0 +1,25 @@
+#include <cstdint>
+
+#include "wasmdemo/fastmod.h"
+
+FastModulo::FastModulo(uint32_t divisor) : _divisor(divisor) {
+  // The reciprocal is floor((2^128 - 1) / divisor) + 1, computed by long
+  // division of 2^128 - 1 in 32-bit digits; each step divides a number below
+  // divisor * 2^32, so 64-bit arithmetic suffices.
+  uint64_t digits[4];
+  uint64_t remainder = 0;
+  for (uint64_t& digit : digits) {
+    const uint64_t dividend = (remainder << 32) | 0xffffffff;
+    digit = dividend / divisor;
+    remainder = dividend % divisor;
+  }
+  _reciprocalHigh = (digits[0] << 32) | digits[1];
+  _reciprocalLow = (digits[2] << 32) | digits[3];
+
+  // Add one, carrying into the upper half. For a divisor of 1 this wraps the
+  // reciprocal around to zero, which still yields the correct remainder, 0.
+  _reciprocalLow++;
+  if (_reciprocalLow == 0) {
+    _reciprocalHigh++;
+  }
+}
@@ -1,7 +1,12 @@
 #include "wasmdemo/hash.h"
 #include "wasmdemo/macros.h"
+#include "wasmdemo/stats.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <numeric>
 
 /// start of md5 block
 /*
@@ -104,6 +109,8 @@ static const void *body(MD5_CTX *ctx, const void *data, unsigned int size)
 	MD5_u32plus a, b, c, d;
 	MD5_u32plus saved_a, saved_b, saved_c, saved_d;
 
+	WASMDEMO_STATS_ADD(md5Blocks, size / 64);
+
 	ptr = (const unsigned char *)data;
 
 	a = ctx->a;
@@ -291,14 +298,379 @@ void MD5_Final(unsigned char *result, MD5_CTX *ctx)
 
 /// end of md5 block
 
+/// start of multi-lane md5 block
+
+/*
+ * MD5_Multi() hashes several independent messages at a time, one per lane of a
+ * SIMD vector, with the same step macros that body() uses.  The number of lanes
+ * follows the widest vector unit that the compiler was told it may use (e.g.
+ * -msimd128 on wasm32, or -mavx2 natively); without one, every message is
+ * hashed with the scalar implementation above.
+ */
+#if defined(__AVX512F__)
+#define MD5_MULTI_LANES 16
+#elif defined(__AVX2__)
+#define MD5_MULTI_LANES 8
+#elif defined(__SSE2__) || defined(__wasm_simd128__) || defined(__ARM_NEON)
+#define MD5_MULTI_LANES 4
+#else
+#define MD5_MULTI_LANES 0
+#endif
+
+/*
+ * Messages longer than this (four padded blocks) are hashed with the scalar
+ * implementation so that one long message does not keep the other lanes busy
+ * compressing blocks whose results are thrown away.
+ */
+#define MD5_MULTI_MAX_SIZE (4 * 64 - 9)
+
+/*
+ * Hashes the bytes already hashed into prefix (or none, if prefix is NULL)
+ * followed by the size bytes at data.
+ */
+static void md5_single(const MD5_CTX *prefix, const void *data,
+	unsigned int size, unsigned char *result)
+{
+	MD5_CTX ctx;
+
+	if (prefix)
+		ctx = *prefix;
+	else
+		MD5_Init(&ctx);
+	MD5_Update(&ctx, data, size);
+	MD5_Final(result, &ctx);
+}
+
+/*
+ * The number of bytes hashed into prefix that are still in its buffer, rather
+ * than compressed into its state.
+ */
+static unsigned int md5_prefix_buffered(const MD5_CTX *prefix)
+{
+	return prefix ? (prefix->lo & 0x3f) : 0;
+}
+
+#if MD5_MULTI_LANES > 0
+
+typedef MD5_u32plus md5_lanes
+	__attribute__((vector_size(MD5_MULTI_LANES * sizeof(MD5_u32plus))));
+
+/*
+ * Writes the 64-byte block with the given index of the padded message into
+ * buffer, i.e. the message bytes followed by the 0x80 terminator, zeros, and
+ * the message length in bits.  The message is the head_size bytes at head
+ * followed by the size bytes at data, and follows prefix_bits bits that were
+ * already compressed.
+ */
+static void md5_padded_block(unsigned char *buffer, const unsigned char *head,
+	unsigned int head_size, const unsigned char *data, unsigned int size,
+	unsigned long long prefix_bits, unsigned int block_index,
+	unsigned int block_count)
+{
+	unsigned int start, used, head_used, message_size;
+	unsigned long long bit_count;
+	int i;
+
+	message_size = head_size + size;
+	start = block_index * 64;
+	used = 0;
+	if (message_size > start)
+		used = (message_size - start < 64) ? message_size - start : 64;
+
+	head_used = 0;
+	if (head_size > start) {
+		head_used = (head_size - start < used) ? head_size - start : used;
+		std::memcpy(buffer, head + start, head_used);
+	}
+	if (used > head_used)
+		std::memcpy(&buffer[head_used], data + (start + head_used - head_size),
+			used - head_used);
+	std::memset(&buffer[used], 0, 64 - used);
+
+	if (message_size >= start && message_size - start < 64)
+		buffer[message_size - start] = 0x80;
+
+	if (block_index + 1 == block_count) {
+		bit_count = prefix_bits + ((unsigned long long)message_size << 3);
+		for (i = 0; i < 8; i++)
+			buffer[56 + i] = (unsigned char)(bit_count >> (i * 8));
+	}
+}
+
+/*
+ * Hashes count (at most MD5_MULTI_LANES) messages, each of which is the bytes
+ * hashed into prefix (or none, if prefix is NULL) followed by at most
+ * MD5_MULTI_MAX_SIZE - md5_prefix_buffered(prefix) bytes.  Unused lanes are
+ * masked out of every state update.
+ */
+static void md5_lanes_hash(const MD5_CTX *prefix,
+	const unsigned char *const *data, const unsigned int *sizes,
+	unsigned int count, unsigned char *const *results)
+{
+	unsigned char buffer[64];
+	unsigned int block_counts[MD5_MULTI_LANES];
+	unsigned int block_index, max_block_count, lane, j, head_size;
+	unsigned long long prefix_bits;
+	md5_lanes x[16], active;
+	md5_lanes a, b, c, d;
+	md5_lanes saved_a, saved_b, saved_c, saved_d;
+
+/*
+ * The prefix's buffered bytes, if any, are the head of every message, and only
+ * the blocks before them are already part of the prefix's state.
+ */
+	head_size = md5_prefix_buffered(prefix);
+	prefix_bits = 0;
+	if (prefix)
+		prefix_bits = (((unsigned long long)prefix->hi << 29) +
+			prefix->lo - head_size) << 3;
+
+	max_block_count = 0;
+	for (lane = 0; lane < MD5_MULTI_LANES; lane++) {
+		block_counts[lane] = (lane < count) ?
+			(head_size + sizes[lane] + 8) / 64 + 1 : 0;
+		if (block_counts[lane] > max_block_count)
+			max_block_count = block_counts[lane];
+	}
+	WASMDEMO_STATS_ADD(md5Blocks, std::accumulate(block_counts,
+		block_counts + MD5_MULTI_LANES, 0u));
+
+	if (prefix) {
+		a = md5_lanes{} + prefix->a;
+		b = md5_lanes{} + prefix->b;
+		c = md5_lanes{} + prefix->c;
+		d = md5_lanes{} + prefix->d;
+	} else {
+		a = md5_lanes{} + 0x67452301;
+		b = md5_lanes{} + 0xefcdab89;
+		c = md5_lanes{} + 0x98badcfe;
+		d = md5_lanes{} + 0x10325476;
+	}
+
+	for (block_index = 0; block_index < max_block_count; block_index++) {
+		for (lane = 0; lane < MD5_MULTI_LANES; lane++) {
+			if (block_index < block_counts[lane]) {
+				md5_padded_block(buffer,
+					prefix ? prefix->buffer : NULL, head_size,
+					data[lane], sizes[lane], prefix_bits,
+					block_index, block_counts[lane]);
+				active[lane] = 0xffffffff;
+			} else {
+				std::memset(buffer, 0, sizeof(buffer));
+				active[lane] = 0;
+			}
+			for (j = 0; j < 16; j++)
+				x[j][lane] =
+					(MD5_u32plus)buffer[j * 4] |
+					((MD5_u32plus)buffer[j * 4 + 1] << 8) |
+					((MD5_u32plus)buffer[j * 4 + 2] << 16) |
+					((MD5_u32plus)buffer[j * 4 + 3] << 24);
+		}
+
+		saved_a = a;
+		saved_b = b;
+		saved_c = c;
+		saved_d = d;
+
+/* Round 1 */
+		STEP(F, a, b, c, d, x[0], 0xd76aa478, 7)
+		STEP(F, d, a, b, c, x[1], 0xe8c7b756, 12)
+		STEP(F, c, d, a, b, x[2], 0x242070db, 17)
+		STEP(F, b, c, d, a, x[3], 0xc1bdceee, 22)
+		STEP(F, a, b, c, d, x[4], 0xf57c0faf, 7)
+		STEP(F, d, a, b, c, x[5], 0x4787c62a, 12)
+		STEP(F, c, d, a, b, x[6], 0xa8304613, 17)
+		STEP(F, b, c, d, a, x[7], 0xfd469501, 22)
+		STEP(F, a, b, c, d, x[8], 0x698098d8, 7)
+		STEP(F, d, a, b, c, x[9], 0x8b44f7af, 12)
+		STEP(F, c, d, a, b, x[10], 0xffff5bb1, 17)
+		STEP(F, b, c, d, a, x[11], 0x895cd7be, 22)
+		STEP(F, a, b, c, d, x[12], 0x6b901122, 7)
+		STEP(F, d, a, b, c, x[13], 0xfd987193, 12)
+		STEP(F, c, d, a, b, x[14], 0xa679438e, 17)
+		STEP(F, b, c, d, a, x[15], 0x49b40821, 22)
+
+/* Round 2 */
+		STEP(G, a, b, c, d, x[1], 0xf61e2562, 5)
+		STEP(G, d, a, b, c, x[6], 0xc040b340, 9)
+		STEP(G, c, d, a, b, x[11], 0x265e5a51, 14)
+		STEP(G, b, c, d, a, x[0], 0xe9b6c7aa, 20)
+		STEP(G, a, b, c, d, x[5], 0xd62f105d, 5)
+		STEP(G, d, a, b, c, x[10], 0x02441453, 9)
+		STEP(G, c, d, a, b, x[15], 0xd8a1e681, 14)
+		STEP(G, b, c, d, a, x[4], 0xe7d3fbc8, 20)
+		STEP(G, a, b, c, d, x[9], 0x21e1cde6, 5)
+		STEP(G, d, a, b, c, x[14], 0xc33707d6, 9)
+		STEP(G, c, d, a, b, x[3], 0xf4d50d87, 14)
+		STEP(G, b, c, d, a, x[8], 0x455a14ed, 20)
+		STEP(G, a, b, c, d, x[13], 0xa9e3e905, 5)
+		STEP(G, d, a, b, c, x[2], 0xfcefa3f8, 9)
+		STEP(G, c, d, a, b, x[7], 0x676f02d9, 14)
+		STEP(G, b, c, d, a, x[12], 0x8d2a4c8a, 20)
+
+/* Round 3 */
+		STEP(H, a, b, c, d, x[5], 0xfffa3942, 4)
+		STEP(H2, d, a, b, c, x[8], 0x8771f681, 11)
+		STEP(H, c, d, a, b, x[11], 0x6d9d6122, 16)
+		STEP(H2, b, c, d, a, x[14], 0xfde5380c, 23)
+		STEP(H, a, b, c, d, x[1], 0xa4beea44, 4)
+		STEP(H2, d, a, b, c, x[4], 0x4bdecfa9, 11)
+		STEP(H, c, d, a, b, x[7], 0xf6bb4b60, 16)
+		STEP(H2, b, c, d, a, x[10], 0xbebfbc70, 23)
+		STEP(H, a, b, c, d, x[13], 0x289b7ec6, 4)
+		STEP(H2, d, a, b, c, x[0], 0xeaa127fa, 11)
+		STEP(H, c, d, a, b, x[3], 0xd4ef3085, 16)
+		STEP(H2, b, c, d, a, x[6], 0x04881d05, 23)
+		STEP(H, a, b, c, d, x[9], 0xd9d4d039, 4)
+		STEP(H2, d, a, b, c, x[12], 0xe6db99e5, 11)
+		STEP(H, c, d, a, b, x[15], 0x1fa27cf8, 16)
+		STEP(H2, b, c, d, a, x[2], 0xc4ac5665, 23)
+
+/* Round 4 */
+		STEP(I, a, b, c, d, x[0], 0xf4292244, 6)
+		STEP(I, d, a, b, c, x[7], 0x432aff97, 10)
+		STEP(I, c, d, a, b, x[14], 0xab9423a7, 15)
+		STEP(I, b, c, d, a, x[5], 0xfc93a039, 21)
+		STEP(I, a, b, c, d, x[12], 0x655b59c3, 6)
+		STEP(I, d, a, b, c, x[3], 0x8f0ccc92, 10)
+		STEP(I, c, d, a, b, x[10], 0xffeff47d, 15)
+		STEP(I, b, c, d, a, x[1], 0x85845dd1, 21)
+		STEP(I, a, b, c, d, x[8], 0x6fa87e4f, 6)
+		STEP(I, d, a, b, c, x[15], 0xfe2ce6e0, 10)
+		STEP(I, c, d, a, b, x[6], 0xa3014314, 15)
+		STEP(I, b, c, d, a, x[13], 0x4e0811a1, 21)
+		STEP(I, a, b, c, d, x[4], 0xf7537e82, 6)
+		STEP(I, d, a, b, c, x[11], 0xbd3af235, 10)
+		STEP(I, c, d, a, b, x[2], 0x2ad7d2bb, 15)
+		STEP(I, b, c, d, a, x[9], 0xeb86d391, 21)
+
+		a = ((a + saved_a) & active) | (saved_a & ~active);
+		b = ((b + saved_b) & active) | (saved_b & ~active);
+		c = ((c + saved_c) & active) | (saved_c & ~active);
+		d = ((d + saved_d) & active) | (saved_d & ~active);
+	}
+
+	for (lane = 0; lane < count; lane++) {
+		OUT(&results[lane][0], a[lane])
+		OUT(&results[lane][4], b[lane])
+		OUT(&results[lane][8], c[lane])
+		OUT(&results[lane][12], d[lane])
+	}
+}
+
+#endif  // MD5_MULTI_LANES > 0
+
+static void md5_multi(const MD5_CTX *prefix, const void *const *data,
+	const unsigned int *sizes, unsigned int count, unsigned char *results)
+{
+	unsigned int i;
+#if MD5_MULTI_LANES > 0
+	const unsigned char *lane_data[MD5_MULTI_LANES];
+	unsigned int lane_sizes[MD5_MULTI_LANES];
+	unsigned char *lane_results[MD5_MULTI_LANES];
+	unsigned int lane_count = 0;
+	unsigned int max_size = MD5_MULTI_MAX_SIZE - md5_prefix_buffered(prefix);
+
+	for (i = 0; i < count; i++) {
+		if (sizes[i] > max_size) {
+			md5_single(prefix, data[i], sizes[i], &results[i * 16]);
+			continue;
+		}
+
+		lane_data[lane_count] = (const unsigned char *)data[i];
+		lane_sizes[lane_count] = sizes[i];
+		lane_results[lane_count] = &results[i * 16];
+		if (++lane_count == MD5_MULTI_LANES) {
+			md5_lanes_hash(prefix, lane_data, lane_sizes, lane_count,
+				lane_results);
+			lane_count = 0;
+		}
+	}
+
+/*
+ * Leftover messages that fill fewer than half of the lanes are cheaper to hash
+ * one at a time than with a mostly-idle vector.
+ */
+	if (lane_count * 2 >= MD5_MULTI_LANES) {
+		md5_lanes_hash(prefix, lane_data, lane_sizes, lane_count, lane_results);
+	} else {
+		for (i = 0; i < lane_count; i++)
+			md5_single(prefix, lane_data[i], lane_sizes[i], lane_results[i]);
+	}
+#else
+	for (i = 0; i < count; i++)
+		md5_single(prefix, data[i], sizes[i], &results[i * 16]);
+#endif
+}
+
+void MD5_Multi(const void *const *data, const unsigned int *sizes,
+	unsigned int count, unsigned char *results)
+{
+	md5_multi(NULL, data, sizes, count, results);
+}
+
+void MD5_Multi_Prefixed(const MD5_CTX *prefix, const void *const *data,
+	const unsigned int *sizes, unsigned int count, unsigned char *results)
+{
+	md5_multi(prefix, data, sizes, count, results);
+}
+
+/// end of multi-lane md5 block
+
 WASM_EXPORT("hash")
 unsigned char* hash(const char *str, const unsigned int size) {
   static unsigned char outputHash[16];
-  static MD5_CTX hashContext;
 
+  MD5_CTX hashContext;
   MD5_Init(&hashContext);
   MD5_Update(&hashContext, str, size);
   MD5_Final(outputHash, &hashContext);
 
   return outputHash;
 }
+
+// The number of inputs that hashMulti() passes to each MD5_Multi() call.
+static const unsigned int HASH_MULTI_CHUNK_SIZE = 64;
+
+WASM_EXPORT("hashMulti")
+void hashMulti(const char *data, const int32_t *offsets, int32_t count, unsigned char *results) {
+  if (count < 0) {
+    abort();
+  }
+
+  const void *chunkData[HASH_MULTI_CHUNK_SIZE];
+  unsigned int chunkSizes[HASH_MULTI_CHUNK_SIZE];
+  const unsigned int inputCount = static_cast<unsigned int>(count);
+  for (unsigned int chunkStart = 0; chunkStart < inputCount; chunkStart += HASH_MULTI_CHUNK_SIZE) {
+    const unsigned int chunkSize = std::min(HASH_MULTI_CHUNK_SIZE, inputCount - chunkStart);
+    for (unsigned int i = 0; i < chunkSize; i++) {
+      const int32_t start = offsets[chunkStart + i];
+      chunkData[i] = data + start;
+      chunkSizes[i] = static_cast<unsigned int>(offsets[chunkStart + i + 1] - start);
+    }
+    MD5_Multi(chunkData, chunkSizes, chunkSize, results + chunkStart * 16);
+  }
+}
+
+WASM_EXPORT("hashContextSize")
+int32_t hashContextSize() {
+  return static_cast<int32_t>(sizeof(MD5_CTX));
+}
+
+WASM_EXPORT("hashInit")
+void hashInit(MD5_CTX *context) {
+  MD5_Init(context);
+}
+
+WASM_EXPORT("hashUpdate")
+void hashUpdate(MD5_CTX *context, const char *data, int32_t size) {
+  if (size < 0) {
+    abort();
+  }
+  MD5_Update(context, data, static_cast<unsigned int>(size));
+}
+
+WASM_EXPORT("hashFinal")
+void hashFinal(MD5_CTX *context, unsigned char *result) {
+  MD5_Final(result, context);
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#if WASMDEMO_THREADS
+#include <mutex>
+#endif
+
+#include "wasmdemo/logging.h"
+#include "wasmdemo/macros.h"
+#include "wasmdemo/wasmdemo.h"
+
+namespace {
+
+// The size of the buffer that log lines are collected in, which is also the
+// most that a single call to the `log` import passes.
+const uint32_t LOG_BUFFER_SIZE = 4096;
+
+const std::string_view LOG_LEVEL_PREFIXES[] = {
+  "DEBUG: ",
+  "INFO: ",
+  "WARNING: ",
+  "ERROR: ",
+};
+
+char gLogBuffer[LOG_BUFFER_SIZE];
+uint32_t gLogLength = 0;
+std::atomic<int> gLogLevel{WASMDEMO_MIN_LOG_LEVEL};
+#if WASMDEMO_THREADS
+std::mutex gLogMutex;
+#endif
+
+// The caller holds gLogMutex.
+void flushLogLocked() {
+  if (gLogLength > 0) {
+    log(gLogBuffer, static_cast<int32_t>(gLogLength));
+    gLogLength = 0;
+  }
+}
+
+// Appends as much of `text` as fits. The caller holds gLogMutex.
+void appendLogLocked(std::string_view text) {
+  const uint32_t length = std::min(static_cast<uint32_t>(text.length()), LOG_BUFFER_SIZE - gLogLength);
+  memcpy(gLogBuffer + gLogLength, text.data(), length);
+  gLogLength += length;
+}
+
+} // namespace
+
+LogLine& LogLine::operator<<(std::string_view text) {
+  const uint32_t length = std::min(static_cast<uint32_t>(text.length()), CAPACITY - _length);
+  memcpy(_text + _length, text.data(), length);
+  _length += length;
+  return *this;
+}
+
+void writeLog(LogLevel level, std::string_view message) {
+  if (static_cast<int>(level) < gLogLevel.load(std::memory_order_relaxed)) {
+    return;
+  }
+  const std::string_view prefix = LOG_LEVEL_PREFIXES[static_cast<uint8_t>(level)];
+
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(gLogMutex);
+#endif
+  // A line longer than the whole buffer is cut short, keeping its '\n'.
+  const size_t lineLength = std::min(prefix.length() + message.length() + 1, size_t{LOG_BUFFER_SIZE});
+  if (gLogLength + lineLength > LOG_BUFFER_SIZE) {
+    flushLogLocked();
+  }
+  appendLogLocked(prefix);
+  appendLogLocked(message.substr(0, lineLength - prefix.length() - 1));
+  appendLogLocked("\n");
+  if (level == LogLevel::Error) {
+    flushLogLocked();
+  }
+}
+
+WASM_EXPORT("flushLog")
+void flushLog() {
+#if WASMDEMO_THREADS
+  std::lock_guard<std::mutex> lock(gLogMutex);
+#endif
+  flushLogLocked();
+}
+
+WASM_EXPORT("setLogLevel")
+void setLogLevel(int32_t level) {
+  if (level < 0 || level > 4) {
+    abort();
+  }
+  gLogLevel.store(std::max(static_cast<int>(level), WASMDEMO_MIN_LOG_LEVEL), std::memory_order_relaxed);
+}
@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#include "wasmdemo/sparse_bitmap.h"
+
+namespace {
+
+// The number of 64-bit words that forEachNonZeroWord() checks for set bits at
+// a time.
+const uint64_t SCAN_BLOCK_WORD_COUNT = 8;
+
+// Returns the bits of the 8 bytes at `bytes`, which may be unaligned, with bit n
+// of the bitmap as bit n of the result.
+uint64_t loadLittleEndianWord(const uint8_t* bytes) {
+  uint64_t word;
+  memcpy(&word, bytes, sizeof(word));
+  if constexpr (std::endian::native == std::endian::big) {
+    word = __builtin_bswap64(word);
+  }
+  return word;
+}
+
+// Calls `visit(wordIndex, word)` for every 64 bits of the first `bitCount` bits
+// of `bitmap` that are not all zero, with the bits past `bitCount` cleared,
+// until it returns false. Most of a sparse bitmap is zero, so it is checked a
+// block of words at a time, which runs about as fast as memory allows.
+template <typename Visit>
+void forEachNonZeroWord(const uint8_t* bitmap, uint64_t bitCount, Visit visit) {
+  const uint64_t fullWordCount = bitCount / 64;
+  uint64_t i = 0;
+  for (; i + SCAN_BLOCK_WORD_COUNT <= fullWordCount; i += SCAN_BLOCK_WORD_COUNT) {
+    uint64_t words[SCAN_BLOCK_WORD_COUNT];
+    memcpy(words, bitmap + i * 8, sizeof(words));
+    uint64_t anyBits = 0;
+    for (uint64_t word : words) {
+      anyBits |= word;
+    }
+    if (anyBits == 0) {
+      continue;
+    }
+    for (uint64_t j = 0; j < SCAN_BLOCK_WORD_COUNT; j++) {
+      const uint64_t word = loadLittleEndianWord(bitmap + (i + j) * 8);
+      if (word != 0 && !visit(i + j, word)) {
+        return;
+      }
+    }
+  }
+  for (; i < fullWordCount; i++) {
+    const uint64_t word = loadLittleEndianWord(bitmap + i * 8);
+    if (word != 0 && !visit(i, word)) {
+      return;
+    }
+  }
+
+  // Don't read past the last byte of the partial word.
+  const uint64_t remainingBitCount = bitCount % 64;
+  if (remainingBitCount != 0) {
+    uint8_t bytes[8] = {};
+    memcpy(bytes, bitmap + fullWordCount * 8, (remainingBitCount + 7) / 8);
+    const uint64_t word = loadLittleEndianWord(bytes) & ((uint64_t{1} << remainingBitCount) - 1);
+    if (word != 0) {
+      visit(fullWordCount, word);
+    }
+  }
+}
+
+} // namespace
+
+SparseBitmap* SparseBitmap::createIfSmaller(const uint8_t* bitmap, uint64_t bitCount) {
+  const uint64_t containerCount = (bitCount + CONTAINER_BIT_COUNT - 1) / CONTAINER_BIT_COUNT;
+  const uint64_t denseSize = (bitCount + 7) / 8;
+  const uint64_t containersSize = (containerCount + 1) * sizeof(uint32_t);
+  if (containersSize * 4 > denseSize) {
+    return nullptr;
+  }
+  const uint64_t maxSetBitCount = (denseSize / 4 - containersSize) / sizeof(uint16_t);
+
+  uint64_t setBitCount = 0;
+  forEachNonZeroWord(bitmap, bitCount, [&setBitCount, maxSetBitCount](uint64_t, uint64_t word) {
+    setBitCount += static_cast<uint64_t>(std::popcount(word));
+    return setBitCount <= maxSetBitCount;
+  });
+  if (setBitCount > maxSetBitCount) {
+    return nullptr;
+  }
+
+  auto* sparseBitmap = new SparseBitmap();
+  std::vector<uint32_t>& containerStarts = sparseBitmap->_containerStarts;
+  std::vector<uint16_t>& lowBits = sparseBitmap->_lowBits;
+  containerStarts.reserve(containerCount + 1);
+  lowBits.reserve(setBitCount);
+  forEachNonZeroWord(bitmap, bitCount, [&containerStarts, &lowBits](uint64_t wordIndex, uint64_t word) {
+    // Start every container up to the one that this word is in.
+    const uint64_t container = wordIndex * 64 / CONTAINER_BIT_COUNT;
+    while (containerStarts.size() <= container) {
+      containerStarts.push_back(static_cast<uint32_t>(lowBits.size()));
+    }
+    for (; word != 0; word &= word - 1) {
+      lowBits.push_back(static_cast<uint16_t>(wordIndex * 64 + static_cast<uint64_t>(std::countr_zero(word))));
+    }
+    return true;
+  });
+  while (containerStarts.size() <= containerCount) {
+    containerStarts.push_back(static_cast<uint32_t>(lowBits.size()));
+  }
+  return sparseBitmap;
+}
+
+bool SparseBitmap::isBitSet(uint64_t n) const {
+  const uint64_t container = n / CONTAINER_BIT_COUNT;
+  const uint16_t* const first = _lowBits.data() + _containerStarts[container];
+  const uint16_t* const last = _lowBits.data() + _containerStarts[container + 1];
+  return std::binary_search(first, last, static_cast<uint16_t>(n));
+}
+
+size_t SparseBitmap::memoryUsage() const {
+  return _containerStarts.size() * sizeof(uint32_t) + _lowBits.size() * sizeof(uint16_t);
+}
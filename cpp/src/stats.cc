@@ -0,0 +1,89 @@
+#include <cstdint>
+#include <ctime>
+
+#include "wasmdemo/macros.h"
+#include "wasmdemo/stats.h"
+
+namespace {
+
+// The snapshot that readStats() returns.
+WasmdemoStats gStatsSnapshot;
+
+} // namespace
+
+#if WASMDEMO_STATS
+
+WasmdemoStats gStats;
+
+uint64_t statsClockNanos() {
+  timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return static_cast<uint64_t>(time.tv_sec) * 1000000000 + static_cast<uint64_t>(time.tv_nsec);
+}
+
+namespace {
+
+typedef uint64_t WasmdemoStats::*Counter;
+
+// Every counter of WasmdemoStats but bloomNegativeProbeDepths.
+const Counter COUNTERS[] = {
+  &WasmdemoStats::bloomFiltersCreated,
+  &WasmdemoStats::bloomCreateNanos,
+  &WasmdemoStats::bloomProbes,
+  &WasmdemoStats::bloomPositives,
+  &WasmdemoStats::bloomBatchProbeNanos,
+  &WasmdemoStats::md5Blocks,
+  &WasmdemoStats::base64DecodedBytes,
+  &WasmdemoStats::base64DecodeNanos,
+  &WasmdemoStats::allocations,
+  &WasmdemoStats::allocatedBytes,
+};
+
+// Other threads may be counting while the counters are read or reset.
+uint64_t loadStat(const uint64_t& counter) {
+#if WASMDEMO_THREADS
+  return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+#else
+  return counter;
+#endif
+}
+
+void clearStat(uint64_t& counter) {
+#if WASMDEMO_THREADS
+  __atomic_store_n(&counter, 0, __ATOMIC_RELAXED);
+#else
+  counter = 0;
+#endif
+}
+
+} // namespace
+
+#endif // WASMDEMO_STATS
+
+WASM_EXPORT("readStats")
+const WasmdemoStats* readStats() {
+  gStatsSnapshot = WasmdemoStats();
+  gStatsSnapshot.version = WASMDEMO_STATS_VERSION;
+#if WASMDEMO_STATS
+  gStatsSnapshot.enabled = 1;
+  for (Counter counter : COUNTERS) {
+    gStatsSnapshot.*counter = loadStat(gStats.*counter);
+  }
+  for (uint32_t i = 0; i < BLOOM_PROBE_DEPTH_BUCKET_COUNT; i++) {
+    gStatsSnapshot.bloomNegativeProbeDepths[i] = loadStat(gStats.bloomNegativeProbeDepths[i]);
+  }
+#endif
+  return &gStatsSnapshot;
+}
+
+WASM_EXPORT("resetStats")
+void resetStats() {
+#if WASMDEMO_STATS
+  for (Counter counter : COUNTERS) {
+    clearStat(gStats.*counter);
+  }
+  for (uint64_t& depthCount : gStats.bloomNegativeProbeDepths) {
+    clearStat(depthCount);
+  }
+#endif
+}
@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <functional>
+
+#include "wasmdemo/thread_pool.h"
+
+#if WASMDEMO_THREADS
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+  if (threadCount == 0) {
+    threadCount = std::thread::hardware_concurrency();
+  }
+  // The calling thread runs tasks too, so it needs one fewer worker.
+  for (uint32_t i = 1; i < threadCount; i++) {
+    _workers.emplace_back([this] { runWorker(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+    _generation++;
+  }
+  _workAvailable.notify_all();
+  for (std::thread& worker : _workers) {
+    worker.join();
+  }
+}
+
+uint32_t ThreadPool::threadCount() const {
+  return static_cast<uint32_t>(_workers.size()) + 1;
+}
+
+void ThreadPool::parallelFor(uint32_t taskCount, const std::function<void(uint32_t)>& task) {
+  if (_workers.empty() || taskCount <= 1) {
+    for (uint32_t i = 0; i < taskCount; i++) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _task = &task;
+    _taskCount = taskCount;
+    _nextTask.store(0, std::memory_order_relaxed);
+    _busyWorkerCount = static_cast<uint32_t>(_workers.size());
+    _generation++;
+  }
+  _workAvailable.notify_all();
+
+  runTasks();
+
+  // Every worker must be done with `task`, which is about to go out of scope,
+  // and not just every task index taken.
+  std::unique_lock<std::mutex> lock(_mutex);
+  _workDone.wait(lock, [this] { return _busyWorkerCount == 0; });
+  _task = nullptr;
+}
+
+void ThreadPool::runWorker() {
+  uint64_t seenGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _workAvailable.wait(lock, [&] { return _generation != seenGeneration; });
+      seenGeneration = _generation;
+      if (_stopping) {
+        return;
+      }
+    }
+
+    runTasks();
+
+    bool isLastWorker;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      isLastWorker = --_busyWorkerCount == 0;
+    }
+    if (isLastWorker) {
+      _workDone.notify_one();
+    }
+  }
+}
+
+void ThreadPool::runTasks() {
+  while (true) {
+    const uint32_t i = _nextTask.fetch_add(1, std::memory_order_relaxed);
+    if (i >= _taskCount) {
+      return;
+    }
+    (*_task)(i);
+  }
+}
+
+void withSharedThreadPool(uint32_t threadCount, const std::function<void(ThreadPool&)>& function) {
+  static std::mutex mutex;
+  static ThreadPool* pool = nullptr;
+  static uint32_t poolRequestedThreadCount = 0;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!pool || poolRequestedThreadCount != threadCount) {
+    delete pool;
+    pool = new ThreadPool(threadCount);
+    poolRequestedThreadCount = threadCount;
+  }
+  function(*pool);
+}
+
+#else // WASMDEMO_THREADS
+
+ThreadPool::ThreadPool(uint32_t) {
+}
+
+ThreadPool::~ThreadPool() {
+}
+
+uint32_t ThreadPool::threadCount() const {
+  return 1;
+}
+
+void ThreadPool::parallelFor(uint32_t taskCount, const std::function<void(uint32_t)>& task) {
+  for (uint32_t i = 0; i < taskCount; i++) {
+    task(i);
+  }
+}
+
+void withSharedThreadPool(uint32_t, const std::function<void(ThreadPool&)>& function) {
+  static ThreadPool pool(1);
+  function(pool);
+}
+
+#endif // WASMDEMO_THREADS
@@ -1,7 +1,9 @@
+#include <cstdint>
 #include <cstdlib>
 
 #include <algorithm>
-#include <string>
+#include <charconv>
+#include <string_view>
 
 #include "wasmdemo/macros.h"
 #include "wasmdemo/wasmdemo.h"
@@ -16,9 +18,19 @@ void echo(const char* s, int32_t len) {
 
 WASM_EXPORT("echo_signed_unsigned")
 void echo_signed_unsigned(int32_t sint, uint32_t usint) {
-  const auto s = std::string("") + "signed=" + std::to_string(sint)
-      + " unsigned=" + std::to_string(usint);
-  log(s.c_str(), static_cast<int32_t>(s.length()));
+  // Formatted by hand, so that the module doesn't need std::string.
+  char s[48];
+  char* end = s;
+  const auto append = [&end](std::string_view text) {
+    for (char c : text) {
+      *end++ = c;
+    }
+  };
+  append("signed=");
+  end = std::to_chars(end, s + sizeof(s), sint).ptr;
+  append(" unsigned=");
+  end = std::to_chars(end, s + sizeof(s), usint).ptr;
+  log(s, static_cast<int32_t>(end - s));
 }
 
 WASM_EXPORT("add")
@@ -31,22 +43,5 @@ void reverse_string(char* data, int size) {
   if (size < 0) {
     std::abort();
   }
-  std::string s(data, static_cast<std::string::size_type>(size));
-  std::reverse(s.begin(), s.end());
-  for (int i=0; i<size; i++) {
-    data[i] = s[static_cast<std::string::size_type>(i)];
-  }
-}
-
-WASM_EXPORT("malloc")
-void* my_wasm_malloc(int size) {
-  if (size < 0) {
-    abort();
-  }
-  return malloc(static_cast<size_t>(size));
-}
-
-WASM_EXPORT("free")
-void my_wasm_free(void* ptr) {
-  free(ptr);
+  std::reverse(data, data + size);
 }
@@ -0,0 +1,311 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "wasmdemo/xxh3.h"
+
+// A port of the scalar XXH3_128bits() code paths of xxHash 0.8
+// (https://github.com/Cyan4973/xxHash, BSD 2-Clause License), specialized for
+// the default secret and a seed of zero. The names of the helpers follow the
+// names of their counterparts in xxhash.h.
+
+namespace {
+
+const uint32_t PRIME32_1 = 0x9E3779B1U;
+const uint32_t PRIME32_2 = 0x85EBCA77U;
+const uint32_t PRIME32_3 = 0xC2B2AE3DU;
+
+const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+const uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+const uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+// The default secret, taken from FARSH.
+const size_t SECRET_SIZE = 192;
+const uint8_t SECRET[SECRET_SIZE] = {
+  0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+  0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+  0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+  0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+  0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+  0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+  0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+  0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+  0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+  0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+  0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+  0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+// The smallest secret that xxHash allows, whose size some offsets depend on.
+const size_t SECRET_SIZE_MIN = 136;
+
+const size_t MIDSIZE_MAX = 240;
+const size_t MIDSIZE_STARTOFFSET = 3;
+const size_t MIDSIZE_LASTOFFSET = 17;
+
+const size_t STRIPE_LEN = 64;
+const size_t SECRET_CONSUME_RATE = 8;
+const size_t ACC_NB = STRIPE_LEN / sizeof(uint64_t);
+const size_t SECRET_LASTACC_START = 7;
+const size_t SECRET_MERGEACCS_START = 11;
+
+// All of the supported platforms are little-endian.
+uint32_t readLE32(const uint8_t* p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint64_t readLE64(const uint8_t* p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint32_t rotl32(uint32_t x, int r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+uint32_t swap32(uint32_t x) {
+  return __builtin_bswap32(x);
+}
+
+uint64_t swap64(uint64_t x) {
+  return __builtin_bswap64(x);
+}
+
+uint64_t mult32to64(uint64_t a, uint64_t b) {
+  return static_cast<uint64_t>(static_cast<uint32_t>(a)) * static_cast<uint32_t>(b);
+}
+
+Xxh3Hash128 mult64to128(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__) && !defined(__wasm__)
+  __extension__ typedef unsigned __int128 uint128;
+  const uint128 product = static_cast<uint128>(a) * b;
+  return Xxh3Hash128 {static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#else
+  const uint64_t lowLow = mult32to64(a & 0xFFFFFFFF, b & 0xFFFFFFFF);
+  const uint64_t highLow = mult32to64(a >> 32, b & 0xFFFFFFFF);
+  const uint64_t lowHigh = mult32to64(a & 0xFFFFFFFF, b >> 32);
+  const uint64_t highHigh = mult32to64(a >> 32, b >> 32);
+  const uint64_t cross = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+  const uint64_t high = (highLow >> 32) + (cross >> 32) + highHigh;
+  const uint64_t low = (cross << 32) | (lowLow & 0xFFFFFFFF);
+  return Xxh3Hash128 {low, high};
+#endif
+}
+
+uint64_t mul128Fold64(uint64_t a, uint64_t b) {
+  const Xxh3Hash128 product = mult64to128(a, b);
+  return product.low64 ^ product.high64;
+}
+
+uint64_t xorshift64(uint64_t v, int shift) {
+  return v ^ (v >> shift);
+}
+
+uint64_t xxh64Avalanche(uint64_t h) {
+  h ^= h >> 33;
+  h *= PRIME64_2;
+  h ^= h >> 29;
+  h *= PRIME64_3;
+  h ^= h >> 32;
+  return h;
+}
+
+uint64_t xxh3Avalanche(uint64_t h) {
+  h = xorshift64(h, 37);
+  h *= PRIME_MX1;
+  h = xorshift64(h, 32);
+  return h;
+}
+
+Xxh3Hash128 len1To3(const uint8_t* input, size_t len) {
+  const uint8_t c1 = input[0];
+  const uint8_t c2 = input[len >> 1];
+  const uint8_t c3 = input[len - 1];
+  const uint32_t combinedLow = (static_cast<uint32_t>(c1) << 16) | (static_cast<uint32_t>(c2) << 24)
+      | static_cast<uint32_t>(c3) | (static_cast<uint32_t>(len) << 8);
+  const uint32_t combinedHigh = rotl32(swap32(combinedLow), 13);
+  const uint64_t bitflipLow = readLE32(SECRET) ^ readLE32(SECRET + 4);
+  const uint64_t bitflipHigh = readLE32(SECRET + 8) ^ readLE32(SECRET + 12);
+  return Xxh3Hash128 {xxh64Avalanche(combinedLow ^ bitflipLow), xxh64Avalanche(combinedHigh ^ bitflipHigh)};
+}
+
+Xxh3Hash128 len4To8(const uint8_t* input, size_t len) {
+  const uint32_t inputLow = readLE32(input);
+  const uint32_t inputHigh = readLE32(input + len - 4);
+  const uint64_t input64 = inputLow + (static_cast<uint64_t>(inputHigh) << 32);
+  const uint64_t bitflip = readLE64(SECRET + 16) ^ readLE64(SECRET + 24);
+  const uint64_t keyed = input64 ^ bitflip;
+
+  Xxh3Hash128 m128 = mult64to128(keyed, PRIME64_1 + (len << 2));
+  m128.high64 += m128.low64 << 1;
+  m128.low64 ^= m128.high64 >> 3;
+
+  m128.low64 = xorshift64(m128.low64, 35);
+  m128.low64 *= PRIME_MX2;
+  m128.low64 = xorshift64(m128.low64, 28);
+  m128.high64 = xxh3Avalanche(m128.high64);
+  return m128;
+}
+
+Xxh3Hash128 len9To16(const uint8_t* input, size_t len) {
+  const uint64_t bitflipLow = readLE64(SECRET + 32) ^ readLE64(SECRET + 40);
+  const uint64_t bitflipHigh = readLE64(SECRET + 48) ^ readLE64(SECRET + 56);
+  const uint64_t inputLow = readLE64(input);
+  uint64_t inputHigh = readLE64(input + len - 8);
+  Xxh3Hash128 m128 = mult64to128(inputLow ^ inputHigh ^ bitflipLow, PRIME64_1);
+  m128.low64 += static_cast<uint64_t>(len - 1) << 54;
+  inputHigh ^= bitflipHigh;
+  m128.high64 += inputHigh + mult32to64(static_cast<uint32_t>(inputHigh), PRIME32_2 - 1);
+  m128.low64 ^= swap64(m128.high64);
+
+  Xxh3Hash128 h128 = mult64to128(m128.low64, PRIME64_2);
+  h128.high64 += m128.high64 * PRIME64_2;
+  h128.low64 = xxh3Avalanche(h128.low64);
+  h128.high64 = xxh3Avalanche(h128.high64);
+  return h128;
+}
+
+Xxh3Hash128 len0To16(const uint8_t* input, size_t len) {
+  if (len > 8) {
+    return len9To16(input, len);
+  }
+  if (len >= 4) {
+    return len4To8(input, len);
+  }
+  if (len > 0) {
+    return len1To3(input, len);
+  }
+  const uint64_t bitflipLow = readLE64(SECRET + 64) ^ readLE64(SECRET + 72);
+  const uint64_t bitflipHigh = readLE64(SECRET + 80) ^ readLE64(SECRET + 88);
+  return Xxh3Hash128 {xxh64Avalanche(bitflipLow), xxh64Avalanche(bitflipHigh)};
+}
+
+uint64_t mix16B(const uint8_t* input, const uint8_t* secret) {
+  return mul128Fold64(readLE64(input) ^ readLE64(secret), readLE64(input + 8) ^ readLE64(secret + 8));
+}
+
+Xxh3Hash128 mix32B(Xxh3Hash128 acc, const uint8_t* input1, const uint8_t* input2, const uint8_t* secret) {
+  acc.low64 += mix16B(input1, secret);
+  acc.low64 ^= readLE64(input2) + readLE64(input2 + 8);
+  acc.high64 += mix16B(input2, secret + 16);
+  acc.high64 ^= readLE64(input1) + readLE64(input1 + 8);
+  return acc;
+}
+
+// The finalization shared by len17To128() and len129To240().
+Xxh3Hash128 finalizeMidsize(Xxh3Hash128 acc, size_t len) {
+  Xxh3Hash128 h128;
+  h128.low64 = acc.low64 + acc.high64;
+  h128.high64 = acc.low64 * PRIME64_1 + acc.high64 * PRIME64_4 + len * PRIME64_2;
+  h128.low64 = xxh3Avalanche(h128.low64);
+  h128.high64 = 0 - xxh3Avalanche(h128.high64);
+  return h128;
+}
+
+Xxh3Hash128 len17To128(const uint8_t* input, size_t len) {
+  Xxh3Hash128 acc {len * PRIME64_1, 0};
+  if (len > 32) {
+    if (len > 64) {
+      if (len > 96) {
+        acc = mix32B(acc, input + 48, input + len - 64, SECRET + 96);
+      }
+      acc = mix32B(acc, input + 32, input + len - 48, SECRET + 64);
+    }
+    acc = mix32B(acc, input + 16, input + len - 32, SECRET + 32);
+  }
+  acc = mix32B(acc, input, input + len - 16, SECRET);
+  return finalizeMidsize(acc, len);
+}
+
+Xxh3Hash128 len129To240(const uint8_t* input, size_t len) {
+  Xxh3Hash128 acc {len * PRIME64_1, 0};
+  for (size_t i = 32; i < 160; i += 32) {
+    acc = mix32B(acc, input + i - 32, input + i - 16, SECRET + i - 32);
+  }
+  acc.low64 = xxh3Avalanche(acc.low64);
+  acc.high64 = xxh3Avalanche(acc.high64);
+  for (size_t i = 160; i <= len; i += 32) {
+    acc = mix32B(acc, input + i - 32, input + i - 16, SECRET + MIDSIZE_STARTOFFSET + i - 160);
+  }
+  acc = mix32B(acc, input + len - 16, input + len - 32, SECRET + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET - 16);
+  return finalizeMidsize(acc, len);
+}
+
+void accumulate512(uint64_t* acc, const uint8_t* input, const uint8_t* secret) {
+  for (size_t lane = 0; lane < ACC_NB; lane++) {
+    const uint64_t dataValue = readLE64(input + lane * 8);
+    const uint64_t dataKey = dataValue ^ readLE64(secret + lane * 8);
+    acc[lane ^ 1] += dataValue;
+    acc[lane] += mult32to64(dataKey & 0xFFFFFFFF, dataKey >> 32);
+  }
+}
+
+void accumulate(uint64_t* acc, const uint8_t* input, const uint8_t* secret, size_t stripeCount) {
+  for (size_t n = 0; n < stripeCount; n++) {
+    accumulate512(acc, input + n * STRIPE_LEN, secret + n * SECRET_CONSUME_RATE);
+  }
+}
+
+void scrambleAcc(uint64_t* acc, const uint8_t* secret) {
+  for (size_t lane = 0; lane < ACC_NB; lane++) {
+    uint64_t acc64 = acc[lane];
+    acc64 = xorshift64(acc64, 47);
+    acc64 ^= readLE64(secret + lane * 8);
+    acc64 *= PRIME32_1;
+    acc[lane] = acc64;
+  }
+}
+
+uint64_t mergeAccs(const uint64_t* acc, const uint8_t* secret, uint64_t start) {
+  uint64_t result = start;
+  for (size_t i = 0; i < 4; i++) {
+    result += mul128Fold64(acc[2 * i] ^ readLE64(secret + 16 * i), acc[2 * i + 1] ^ readLE64(secret + 16 * i + 8));
+  }
+  return xxh3Avalanche(result);
+}
+
+Xxh3Hash128 hashLong(const uint8_t* input, size_t len) {
+  uint64_t acc[ACC_NB] = {PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+  const size_t stripesPerBlock = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+  const size_t blockLen = STRIPE_LEN * stripesPerBlock;
+  const size_t blockCount = (len - 1) / blockLen;
+  for (size_t n = 0; n < blockCount; n++) {
+    accumulate(acc, input + n * blockLen, SECRET, stripesPerBlock);
+    scrambleAcc(acc, SECRET + SECRET_SIZE - STRIPE_LEN);
+  }
+
+  // The last partial block, and then the last stripe.
+  const size_t stripeCount = ((len - 1) - blockLen * blockCount) / STRIPE_LEN;
+  accumulate(acc, input + blockCount * blockLen, SECRET, stripeCount);
+  accumulate512(acc, input + len - STRIPE_LEN, SECRET + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START);
+
+  return Xxh3Hash128 {
+    mergeAccs(acc, SECRET + SECRET_MERGEACCS_START, len * PRIME64_1),
+    mergeAccs(acc, SECRET + SECRET_SIZE - sizeof(acc) - SECRET_MERGEACCS_START, ~(len * PRIME64_2)),
+  };
+}
+
+} // namespace
+
+Xxh3Hash128 xxh3Hash128(const void* data, size_t size) {
+  const auto* input = static_cast<const uint8_t*>(data);
+  if (size <= 16) {
+    return len0To16(input, size);
+  }
+  if (size <= 128) {
+    return len17To128(input, size);
+  }
+  if (size <= MIDSIZE_MAX) {
+    return len129To240(input, size);
+  }
+  return hashLong(input, size);
+}
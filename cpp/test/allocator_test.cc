@@ -0,0 +1,117 @@
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include "wasmdemo/allocator.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+bool isAligned(const void* ptr, uintptr_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(wasmdemo, arena_alloc_ShouldReturnAlignedDisjointMemory) {
+  Arena arena(256);
+  std::vector<uint8_t*> allocations;
+  std::vector<uint32_t> sizes;
+  for (uint32_t size : {0u, 1u, 15u, 16u, 17u, 100u, 255u, 256u, 1000u, 3u, 64u}) {
+    auto* ptr = static_cast<uint8_t*>(arena.alloc(size));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_TRUE(isAligned(ptr, Arena::ALIGNMENT)) << "size=" << size;
+    memset(ptr, static_cast<int>(allocations.size()), size);
+    allocations.push_back(ptr);
+    sizes.push_back(size);
+  }
+
+  // No allocation overwrote another.
+  for (size_t i = 0; i < allocations.size(); i++) {
+    for (uint32_t j = 0; j < sizes[i]; j++) {
+      ASSERT_EQ(allocations[i][j], static_cast<uint8_t>(i)) << "i=" << i << " j=" << j;
+    }
+  }
+}
+
+TEST(wasmdemo, arena_reset_ShouldReuseTheSameBlocks) {
+  Arena arena(1024);
+  std::vector<void*> firstRound;
+  for (uint32_t i = 0; i < 100; i++) {
+    firstRound.push_back(arena.alloc(i * 7));
+  }
+  const size_t capacity = arena.capacity();
+  EXPECT_GT(capacity, 0u);
+
+  for (int round = 0; round < 10; round++) {
+    arena.reset();
+    for (uint32_t i = 0; i < 100; i++) {
+      ASSERT_EQ(arena.alloc(i * 7), firstRound[i]) << "round=" << round << " i=" << i;
+    }
+    EXPECT_EQ(arena.capacity(), capacity);
+  }
+}
+
+TEST(wasmdemo, sizeClassPool_alloc_ShouldReturnAlignedDisjointMemory) {
+  SizeClassPool pool;
+  std::vector<uint8_t*> allocations;
+  std::vector<size_t> sizes;
+  for (size_t size = 0; size <= 2 * SizeClassPool::MAX_CLASS_SIZE; size = size * 3 / 2 + 1) {
+    auto* ptr = static_cast<uint8_t*>(pool.alloc(size));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_TRUE(isAligned(ptr, 16)) << "size=" << size;
+    memset(ptr, static_cast<int>(allocations.size()), size);
+    allocations.push_back(ptr);
+    sizes.push_back(size);
+  }
+
+  for (size_t i = 0; i < allocations.size(); i++) {
+    for (size_t j = 0; j < sizes[i]; j++) {
+      ASSERT_EQ(allocations[i][j], static_cast<uint8_t>(i)) << "i=" << i << " j=" << j;
+    }
+    pool.free(allocations[i]);
+  }
+  pool.free(nullptr);
+}
+
+TEST(wasmdemo, sizeClassPool_free_ShouldRecycleBlocksOfTheSameSizeClass) {
+  SizeClassPool pool;
+  std::set<void*> blocks;
+  for (int i = 0; i < 50; i++) {
+    blocks.insert(pool.alloc(100));
+  }
+  for (void* block : blocks) {
+    pool.free(block);
+  }
+
+  // Any size in the same class gets one of the freed blocks back.
+  for (size_t size : {65u, 100u, 128u}) {
+    for (int i = 0; i < 50; i++) {
+      void* const block = pool.alloc(size);
+      EXPECT_EQ(blocks.count(block), 1u) << "size=" << size << " i=" << i;
+      pool.free(block);
+    }
+  }
+}
+
+TEST(wasmdemo, malloc_ShouldRoundTripThroughFree) {
+  for (int size : {0, 1, 40, 4096, 4097, 100000}) {
+    auto* ptr = static_cast<uint8_t*>(my_wasm_malloc(size));
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 0xAB, static_cast<size_t>(size));
+    my_wasm_free(ptr);
+  }
+  my_wasm_free(nullptr);
+}
+
+TEST(wasmdemo, arenaExports_ShouldAllocateAndReset) {
+  Arena* arena = arenaCreate(4096);
+  void* const first = arenaAlloc(arena, 100);
+  ASSERT_NE(first, nullptr);
+  EXPECT_NE(arenaAlloc(arena, 100), first);
+  arenaReset(arena);
+  EXPECT_EQ(arenaAlloc(arena, 100), first);
+  arenaDestroy(arena);
+}
+
+} // namespace
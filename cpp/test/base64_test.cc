@@ -0,0 +1,189 @@
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "wasmdemo/base64.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::string decode_into_string(std::string_view s) {
+  std::vector<unsigned char> buffer(base64_decoded_size(s) + 1, 0xEE);
+  const size_t size = base64_decode_into(s, buffer.data());
+  EXPECT_EQ(size, base64_decoded_size(s)) << "s=" << s;
+  EXPECT_EQ(buffer[size], 0xEE) << "wrote past the decoded size; s=" << s;
+  return std::string(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(size));
+}
+
+TEST(wasmdemo, base64_decode_ShouldDecodeRfc4648TestVectors) {
+  EXPECT_EQ(base64_decode(std::string_view("")), "");
+  EXPECT_EQ(base64_decode(std::string_view("Zg==")), "f");
+  EXPECT_EQ(base64_decode(std::string_view("Zm8=")), "fo");
+  EXPECT_EQ(base64_decode(std::string_view("Zm9v")), "foo");
+  EXPECT_EQ(base64_decode(std::string_view("Zm9vYg==")), "foob");
+  EXPECT_EQ(base64_decode(std::string_view("Zm9vYmE=")), "fooba");
+  EXPECT_EQ(base64_decode(std::string_view("Zm9vYmFy")), "foobar");
+}
+
+TEST(wasmdemo, base64_decode_ShouldAcceptUnpaddedAndUrlInput) {
+  EXPECT_EQ(base64_decode(std::string_view("Zg")), "f");
+  EXPECT_EQ(base64_decode(std::string_view("Zm8")), "fo");
+  EXPECT_EQ(base64_decode(std::string_view("Zg..")), "f");
+  EXPECT_EQ(base64_decode(std::string_view("-_-_")), "\xfb\xff\xbf");
+  EXPECT_EQ(base64_decode(std::string_view("+/+/")), "\xfb\xff\xbf");
+}
+
+TEST(wasmdemo, base64_decode_ShouldRemoveLinebreaksIfRequested) {
+  EXPECT_EQ(base64_decode(std::string_view("Zm9v\nYmFy\n"), true), "foobar");
+}
+
+TEST(wasmdemo, base64_encode_ShouldRoundTripAllByteValues) {
+  std::string bytes;
+  for (int i = 0; i < 256; i++) {
+    bytes += static_cast<char>(i);
+  }
+  for (size_t length = 0; length <= bytes.length(); length++) {
+    const std::string_view data(bytes.data(), length);
+    EXPECT_EQ(base64_decode(base64_encode(data)), data);
+    EXPECT_EQ(base64_decode(base64_encode(data, true)), data);
+  }
+}
+
+TEST(wasmdemo, base64_ShouldRoundTripLongInputs) {
+  // Long enough to be handled mostly by the vectorized code, with every
+  // possible length of scalar tail.
+  std::string bytes;
+  for (int i = 0; i < 1000; i++) {
+    bytes += static_cast<char>(i * 131 + 7);
+  }
+  for (size_t length = 900; length <= bytes.length(); length++) {
+    const std::string_view data(bytes.data(), length);
+    const std::string encoded = base64_encode(data);
+    const std::string encoded_url = base64_encode(data, true);
+    EXPECT_EQ(encoded.length(), (length + 2) / 3 * 4);
+    EXPECT_EQ(encoded.find_first_of("-_."), std::string::npos);
+    EXPECT_EQ(encoded_url.find_first_of("+/="), std::string::npos);
+    EXPECT_EQ(base64_decode(encoded), data);
+    EXPECT_EQ(base64_decode(encoded_url), data);
+  }
+}
+
+TEST(wasmdemo, base64_decode_ShouldHandlePaddingInTheMiddleOfLongInput) {
+  std::string bytes;
+  for (int i = 0; i < 48; i++) {
+    bytes += static_cast<char>('a' + i % 26);
+  }
+  std::string encoded = base64_encode(bytes);
+  // Padding in the third character of the sixth chunk truncates that chunk to
+  // one byte, but the chunks after it are still decoded.
+  encoded[22] = '=';
+  EXPECT_EQ(base64_decode(encoded), bytes.substr(0, 16) + bytes.substr(18));
+}
+
+TEST(wasmdemo, base64_decode_ShouldDecodeMimeAndPemWithLinebreaks) {
+  std::string bytes;
+  for (int i = 0; i < 500; i++) {
+    bytes += static_cast<char>(i);
+  }
+  EXPECT_EQ(base64_decode(base64_encode_mime(bytes), true), bytes);
+  EXPECT_EQ(base64_decode(base64_encode_pem(bytes), true), bytes);
+}
+
+TEST(wasmdemo, base64_decode_into_ShouldMatchBase64Decode) {
+  for (std::string_view s : {"", "Zg", "Zg==", "Zm8", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=",
+                             "Zm9vYmFy", "Zg..", "RswZ", "Zm9vYmFyZ"}) {
+    EXPECT_EQ(decode_into_string(s), base64_decode(s)) << "s=" << s;
+  }
+}
+
+TEST(wasmdemo, base64_encoded_size_ShouldCountLinebreaks) {
+  EXPECT_EQ(base64_encoded_size(0), 0U);
+  EXPECT_EQ(base64_encoded_size(1), 4U);
+  EXPECT_EQ(base64_encoded_size(3), 4U);
+  EXPECT_EQ(base64_encoded_size(4), 8U);
+  EXPECT_EQ(base64_encoded_size(0, 64), 0U);
+  EXPECT_EQ(base64_encoded_size(48, 64), 64U);
+  EXPECT_EQ(base64_encoded_size(49, 64), 69U);
+  EXPECT_EQ(base64_encoded_size(96, 64), 129U);
+  for (size_t len = 0; len < 300; len++) {
+    const std::string bytes(len, 'x');
+    EXPECT_EQ(base64_encoded_size(len, 64), base64_encode_pem(bytes).length());
+    EXPECT_EQ(base64_encoded_size(len, 76), base64_encode_mime(bytes).length());
+  }
+}
+
+TEST(wasmdemo, base64_encode_into_ShouldMatchBase64Encode) {
+  const std::string bytes = "The quick brown fox jumped over the lazy dog; twice, if you please.";
+  const std::span<const unsigned char> data(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.length());
+
+  std::vector<char> dest(base64_encoded_size(bytes.length(), 76));
+  EXPECT_EQ(base64_encode_into(data, dest, false, 76), dest.size());
+  EXPECT_EQ(std::string(dest.begin(), dest.end()), base64_encode_mime(bytes));
+
+  dest.resize(base64_encoded_size(bytes.length()));
+  EXPECT_EQ(base64_encode_into(data, dest, true), dest.size());
+  EXPECT_EQ(std::string(dest.begin(), dest.end()), base64_encode(bytes, true));
+}
+
+TEST(wasmdemo, base64_into_ShouldNotWriteToATooSmallBuffer) {
+  const std::string bytes = "foobar";
+  const std::span<const unsigned char> data(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.length());
+  std::vector<char> encoded(7, '?');
+  EXPECT_EQ(base64_encode_into(data, encoded), 0U);
+  EXPECT_EQ(std::string(encoded.begin(), encoded.end()), "???????");
+
+  std::vector<unsigned char> decoded(5, '?');
+  EXPECT_EQ(base64_decode_into("Zm9vYmFy", decoded), 0U);
+  EXPECT_EQ(std::string(decoded.begin(), decoded.end()), "?????");
+}
+
+TEST(wasmdemo, base64_decode_into_ShouldRemoveLinebreaksIfRequested) {
+  const std::string_view encoded = "Zm9v\nYmFy\nZg=\n=\n";
+  EXPECT_EQ(base64_decoded_size(encoded, true), 7U);
+  std::vector<unsigned char> decoded(7);
+  EXPECT_EQ(base64_decode_into(encoded, decoded, true), 7U);
+  EXPECT_EQ(std::string(decoded.begin(), decoded.end()), "foobarf");
+}
+
+TEST(wasmdemo, Base64Decoder_ShouldDecodeInputSplitAnywhere) {
+  std::string bytes;
+  for (int i = 0; i < 200; i++) {
+    bytes += static_cast<char>(i * 13);
+  }
+  const std::string encoded = base64_encode_mime(bytes);
+
+  for (size_t piece_length = 1; piece_length <= 9; piece_length++) {
+    Base64Decoder decoder(true);
+    std::vector<unsigned char> decoded(bytes.length() + 2);
+    size_t len_decoded = 0;
+    for (size_t pos = 0; pos < encoded.length(); pos += piece_length) {
+      const std::string_view piece = std::string_view(encoded).substr(pos, piece_length);
+      const size_t max_size = decoder.max_update_size(piece.length());
+      const size_t size = decoder.update(piece, decoded.data() + len_decoded);
+      EXPECT_LE(size, max_size);
+      len_decoded += size;
+    }
+    len_decoded += decoder.finish(decoded.data() + len_decoded);
+    EXPECT_EQ(std::string(decoded.begin(), decoded.begin() + static_cast<std::ptrdiff_t>(len_decoded)), bytes)
+        << "piece_length=" << piece_length;
+  }
+}
+
+TEST(wasmdemo, Base64Decoder_ShouldDecodeAnUnpaddedFinalGroupInFinish) {
+  Base64Decoder decoder;
+  unsigned char decoded[8];
+  EXPECT_EQ(decoder.update("Zm9vYm", decoded), 3U);
+  EXPECT_EQ(decoder.finish(decoded + 3), 1U);
+  EXPECT_EQ(std::string(decoded, decoded + 4), "foob");
+  EXPECT_EQ(decoder.finish(decoded), 0U);
+}
+
+TEST(wasmdemo, base64_decoded_size_ShouldIgnoreADanglingCharacter) {
+  EXPECT_EQ(base64_decoded_size("Z"), 0U);
+  EXPECT_EQ(base64_decoded_size("Zm9vY"), 3U);
+  EXPECT_EQ(decode_into_string("Zm9vY"), "foo");
+}
+
+} // namespace
@@ -0,0 +1,172 @@
+// Compares the probe latency of the classic BloomFilter layout against
+// BlockedBloomFilter at equal false positive rates.
+//
+// The first scenario uses the 50000-entry, 0.0001 false positive rate golden
+// test filter that is shared with demo-website, and a blocked filter sized for
+// the same parameters holding the same keys. The second scenario uses a larger
+// synthetic filter, whose bitmap does not fit in the L2 cache of most machines,
+// which is where the single cache line touched by a blocked probe pays off.
+//
+// Usage: wasmdemo_blocked_bloom_benchmark <golden_test_data_dir>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "wasmdemo/bloom.h"
+#include "wasmdemo/hash.h"
+
+#include "golden_test_data.h"
+
+namespace {
+
+// The synthetic scenario inserts SYNTHETIC_ITEM_COUNT keys and probes as many
+// keys that were not inserted.
+const uint32_t SYNTHETIC_ITEM_COUNT = 2000000;
+const double SYNTHETIC_FALSE_POSITIVE_RATE = 0.01;
+
+// Runs `probe(key)` on every key, BENCHMARK_RUN_COUNT times, and returns the
+// fastest run's average nanoseconds per key. `memberPositives` and `nonMemberPositives`
+// are set to the number of keys for which `probe` returned true among the first
+// `memberCount` keys and among the rest, respectively.
+template <typename Probe>
+double timeProbes(const std::vector<std::string>& keys, size_t memberCount, Probe probe,
+                  size_t& memberPositives, size_t& nonMemberPositives) {
+  const double bestNanos = timeBestOfRuns([&]() {
+    memberPositives = 0;
+    nonMemberPositives = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (probe(keys[i])) {
+        (i < memberCount ? memberPositives : nonMemberPositives)++;
+      }
+    }
+  });
+  return bestNanos / static_cast<double>(keys.size());
+}
+
+// Probes both filters with `keys`, the first `memberCount` of which were
+// inserted into both, and prints the results. Since both filters hash every key
+// with MD5, the time spent hashing alone is printed too; the remainder is the
+// cost of the memory accesses that the layouts differ in. Returns false if
+// either filter reported a false negative.
+bool compareFilters(const char* name, BloomFilter& classic, uint32_t classicSize,
+                    BlockedBloomFilter& blocked, const std::vector<std::string>& keys,
+                    size_t memberCount) {
+  size_t classicMemberPositives, classicNonMemberPositives;
+  const double classicNanos = timeProbes(keys, memberCount, [&classic](const std::string& key) {
+    return classic.mightContain(key.data(), static_cast<uint32_t>(key.length()));
+  }, classicMemberPositives, classicNonMemberPositives);
+
+  size_t blockedMemberPositives, blockedNonMemberPositives;
+  const double blockedNanos = timeProbes(keys, memberCount, [&blocked](const std::string& key) {
+    return blocked.mightContain(key.data(), static_cast<uint32_t>(key.length()));
+  }, blockedMemberPositives, blockedNonMemberPositives);
+
+  size_t unusedMemberPositives, unusedNonMemberPositives;
+  const double md5Nanos = timeProbes(keys, memberCount, [](const std::string& key) {
+    MD5_CTX hashContext;
+    MD5_Init(&hashContext);
+    MD5_Update(&hashContext, key.data(), static_cast<unsigned int>(key.length()));
+    uint8_t md5Hash[16];
+    MD5_Final(md5Hash, &hashContext);
+    return (md5Hash[0] & 0x01) != 0;
+  }, unusedMemberPositives, unusedNonMemberPositives);
+
+  const double nonMemberCount = static_cast<double>(keys.size() - memberCount);
+  std::printf("%s: %zu keys, MD5 alone %.1f ns/key\n", name, keys.size(), md5Nanos);
+  std::printf("  classic: %u bytes, %.1f ns/probe (%.1f beyond MD5), false positive rate %.5f\n",
+              (classicSize + 7) / 8,
+              classicNanos,
+              classicNanos - md5Nanos,
+              static_cast<double>(classicNonMemberPositives) / nonMemberCount);
+  std::printf("  blocked: %u bytes, %.1f ns/probe (%.1f beyond MD5), false positive rate %.5f\n",
+              blocked.serializedSize() - BlockedBloomFilter::HEADER_SIZE,
+              blockedNanos,
+              blockedNanos - md5Nanos,
+              static_cast<double>(blockedNonMemberPositives) / nonMemberCount);
+
+  if (classicMemberPositives != memberCount || blockedMemberPositives != memberCount) {
+    std::fprintf(stderr, "ERROR: %s: false negatives (classic %zu, blocked %zu)\n",
+                 name,
+                 memberCount - classicMemberPositives,
+                 memberCount - blockedMemberPositives);
+    return false;
+  }
+  return true;
+}
+
+bool runGoldenBenchmark(const std::string& dir) {
+  const char* name = "Validation_BloomFilterTest_MD5_50000_0001";
+  GoldenTest test;
+  if (!loadGoldenTest(dir, name, test)) {
+    return false;
+  }
+
+  // The first half of the keys in the golden test data are members.
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < test.membershipTestResults.length(); i++) {
+    keys.push_back(GOLDEN_TEST_DOCUMENT_PREFIX + std::to_string(i));
+  }
+  const size_t memberCount = keys.size() / 2;
+
+  BloomFilter classic(
+      reinterpret_cast<const uint8_t*>(test.bitmap.data()),
+      static_cast<uint32_t>(test.bitmap.size()),
+      static_cast<uint32_t>(test.padding),
+      static_cast<uint32_t>(test.hashCount));
+
+  const std::unique_ptr<BlockedBloomFilter> blocked(BlockedBloomFilter::create(BlockedBloomFilter::blockCountFor(memberCount, 0.0001)));
+  if (!blocked) {
+    std::fprintf(stderr, "ERROR: %s: cannot allocate the blocked filter\n", name);
+    return false;
+  }
+  for (size_t i = 0; i < memberCount; i++) {
+    blocked->insert(keys[i].data(), static_cast<uint32_t>(keys[i].length()));
+  }
+
+  const uint32_t classicSize = static_cast<uint32_t>(test.bitmap.size() * 8) - static_cast<uint32_t>(test.padding);
+  return compareFilters(name, classic, classicSize, *blocked, keys, memberCount);
+}
+
+bool runSyntheticBenchmark() {
+  std::vector<std::string> keys;
+  for (uint32_t i = 0; i < SYNTHETIC_ITEM_COUNT * 2; i++) {
+    keys.push_back("key" + std::to_string(i));
+  }
+
+  // The optimal classic filter for the item count and false positive rate.
+  const uint32_t bitCount = BloomFilterBuilder::bitCountFor(SYNTHETIC_ITEM_COUNT, SYNTHETIC_FALSE_POSITIVE_RATE);
+  const uint32_t hashCount = BloomFilterBuilder::hashCountFor(bitCount, SYNTHETIC_ITEM_COUNT);
+  BloomFilterBuilder builder(bitCount, hashCount);
+
+  const std::unique_ptr<BlockedBloomFilter> blocked(
+      BlockedBloomFilter::create(BlockedBloomFilter::blockCountFor(SYNTHETIC_ITEM_COUNT, SYNTHETIC_FALSE_POSITIVE_RATE)));
+  if (!blocked) {
+    std::fprintf(stderr, "ERROR: synthetic: cannot allocate the blocked filter\n");
+    return false;
+  }
+  for (uint32_t i = 0; i < SYNTHETIC_ITEM_COUNT; i++) {
+    builder.insert(keys[i].data(), static_cast<uint32_t>(keys[i].length()));
+    blocked->insert(keys[i].data(), static_cast<uint32_t>(keys[i].length()));
+  }
+
+  BloomFilter classic(builder.bitmap(), builder.bitmapLength(), builder.padding(), hashCount);
+  const std::string name = "synthetic_" + std::to_string(SYNTHETIC_ITEM_COUNT) + "_01";
+  return compareFilters(name.c_str(), classic, bitCount, *blocked, keys, SYNTHETIC_ITEM_COUNT);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "Usage: %s <golden_test_data_dir>\n", argv[0]);
+    return 2;
+  }
+  const std::string dir(argv[1]);
+
+  bool success = true;
+  success = runGoldenBenchmark(dir) && success;
+  success = runSyntheticBenchmark() && success;
+  return success ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// Compares the throughput of probing a BloomFilter one key at a time through
+// the mightContain() export against probing all of the keys with a single
+// mightContainBatch() call, using the 50000-entry golden test data that is
+// shared with demo-website.
+//
+// The per-key loop mimics what the JavaScript wrapper does for each key: it
+// allocates a buffer, copies the key into it, calls the export, and frees the
+// buffer. The batched run copies all of the keys into one buffer up front.
+//
+// Usage: wasmdemo_bloom_batch_benchmark <golden_test_data_dir>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "wasmdemo/bloom.h"
+
+#include "golden_test_data.h"
+
+namespace {
+
+bool runBenchmark(const std::string& dir, const std::string& name) {
+  GoldenTest test;
+  if (!loadGoldenTest(dir, name, test)) {
+    return false;
+  }
+
+  const int32_t keyCount = static_cast<int32_t>(test.membershipTestResults.length());
+  std::string keys;
+  std::vector<int32_t> offsets {0};
+  for (int32_t i = 0; i < keyCount; i++) {
+    keys += GOLDEN_TEST_DOCUMENT_PREFIX + std::to_string(i);
+    offsets.push_back(static_cast<int32_t>(keys.length()));
+  }
+
+  BloomFilter* bloomFilter = newBloomFilter(
+      test.bitmap.data(),
+      static_cast<int32_t>(test.bitmap.size()),
+      test.padding,
+      test.hashCount);
+
+  std::vector<bool> perKeyResults(static_cast<size_t>(keyCount));
+  const double bestPerKeyNanos = timeBestOfRuns([&]() {
+    for (int32_t i = 0; i < keyCount; i++) {
+      const size_t keyStart = static_cast<size_t>(offsets[static_cast<size_t>(i)]);
+      const size_t keyLength = static_cast<size_t>(offsets[static_cast<size_t>(i) + 1]) - keyStart;
+      char* key = static_cast<char*>(std::malloc(keyLength));
+      std::memcpy(key, keys.data() + keyStart, keyLength);
+      perKeyResults[static_cast<size_t>(i)] = mightContain(bloomFilter, key, static_cast<int32_t>(keyLength));
+      std::free(key);
+    }
+  });
+
+  std::vector<uint8_t> batchResults(static_cast<size_t>((keyCount + 7) / 8));
+  const double bestBatchNanos = timeBestOfRuns([&]() {
+    char* packedKeys = static_cast<char*>(std::malloc(keys.length()));
+    std::memcpy(packedKeys, keys.data(), keys.length());
+    mightContainBatch(bloomFilter, packedKeys, offsets.data(), keyCount, batchResults.data());
+    std::free(packedKeys);
+  });
+
+  deleteBloomFilter(bloomFilter);
+
+  int mismatchCount = 0;
+  for (int32_t i = 0; i < keyCount; i++) {
+    const bool expected = test.membershipTestResults[static_cast<size_t>(i)] == '1';
+    const bool batchResult = (batchResults[static_cast<size_t>(i / 8)] >> (i % 8)) & 0x01;
+    if (perKeyResults[static_cast<size_t>(i)] != expected || batchResult != expected) {
+      mismatchCount++;
+    }
+  }
+
+  std::printf("%s: %d keys, per-key %.1f ns/key, batched %.1f ns/key (%.2fx)\n",
+              name.c_str(),
+              keyCount,
+              bestPerKeyNanos / keyCount,
+              bestBatchNanos / keyCount,
+              bestPerKeyNanos / bestBatchNanos);
+
+  if (mismatchCount != 0) {
+    std::fprintf(stderr, "ERROR: %s: %d results did not match the golden test data\n",
+                 name.c_str(), mismatchCount);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "Usage: %s <golden_test_data_dir>\n", argv[0]);
+    return 2;
+  }
+  const std::string dir(argv[1]);
+
+  bool success = true;
+  success = runBenchmark(dir, "Validation_BloomFilterTest_MD5_50000_01") && success;
+  success = runBenchmark(dir, "Validation_BloomFilterTest_MD5_50000_0001") && success;
+  return success ? 0 : 1;
+}
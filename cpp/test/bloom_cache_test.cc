@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "wasmdemo/base64.h"
+#include "wasmdemo/bloom.h"
+#include "wasmdemo/bloom_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// A dense bitmap of `length` bytes that differs for every `seed`.
+std::vector<int8_t> testBitmap(uint32_t length, uint8_t seed) {
+  std::vector<int8_t> bitmap(length);
+  for (uint32_t i = 0; i < length; i++) {
+    bitmap[i] = static_cast<int8_t>((i * 131 + seed) ^ 0x5a);
+  }
+  return bitmap;
+}
+
+TEST(wasmdemo, bloomCache_ShouldReturnTheSameFilterForTheSameBitmap) {
+  BloomFilterCache* cache = newBloomFilterCache(1 << 20);
+  // { "bits": { "bitmap": "RswZ", "padding": 1 }, "hashCount": 16 }
+  const std::string decoded = base64_decode(std::string_view("RswZ"));
+  const std::vector<int8_t> bitmap(decoded.begin(), decoded.end());
+  const int32_t bitmapLength = static_cast<int32_t>(bitmap.size());
+
+  EXPECT_EQ(bloomFilterCacheLookup(cache, bitmap.data(), bitmapLength, 1, 16), nullptr);
+  BloomFilter* filter = bloomFilterCacheInsert(cache, bitmap.data(), bitmapLength, 1, 16);
+  ASSERT_NE(filter, nullptr);
+
+  // A copy of the bitmap finds the same filter, which behaves like any other.
+  const std::vector<int8_t> bitmapCopy = bitmap;
+  EXPECT_EQ(bloomFilterCacheLookup(cache, bitmapCopy.data(), bitmapLength, 1, 16), filter);
+  EXPECT_EQ(bloomFilterCacheInsert(cache, bitmapCopy.data(), bitmapLength, 1, 16), filter);
+  const std::string document0 = "projects/project-1/databases/database-1/documents/coll/doc0";
+  const std::string document1 = "projects/project-1/databases/database-1/documents/coll/doc1";
+  EXPECT_TRUE(mightContain(filter, document0.data(), static_cast<int32_t>(document0.length())));
+  EXPECT_FALSE(mightContain(filter, document1.data(), static_cast<int32_t>(document1.length())));
+
+  // The padding and hash count are part of the key.
+  EXPECT_EQ(bloomFilterCacheLookup(cache, bitmap.data(), bitmapLength, 2, 16), nullptr);
+  EXPECT_EQ(bloomFilterCacheLookup(cache, bitmap.data(), bitmapLength, 1, 15), nullptr);
+  BloomFilter* otherFilter = bloomFilterCacheInsert(cache, bitmap.data(), bitmapLength, 1, 15);
+  EXPECT_NE(otherFilter, filter);
+
+  // A base64 bitmap is keyed by its text, not by the bitmap that it encodes.
+  EXPECT_EQ(bloomFilterCacheLookupBase64(cache, "RswZ", 4, 1, 16), nullptr);
+  BloomFilter* base64Filter = bloomFilterCacheInsertBase64(cache, "RswZ", 4, 1, 16);
+  EXPECT_NE(base64Filter, filter);
+  EXPECT_EQ(bloomFilterCacheLookupBase64(cache, "RswZ", 4, 1, 16), base64Filter);
+  EXPECT_TRUE(mightContain(base64Filter, document0.data(), static_cast<int32_t>(document0.length())));
+  EXPECT_FALSE(mightContain(base64Filter, document1.data(), static_cast<int32_t>(document1.length())));
+
+  for (int i = 0; i < 3; i++) {
+    bloomFilterCacheRelease(cache, filter);
+  }
+  bloomFilterCacheRelease(cache, otherFilter);
+  bloomFilterCacheRelease(cache, base64Filter);
+  bloomFilterCacheRelease(cache, base64Filter);
+  deleteBloomFilterCache(cache);
+}
+
+TEST(wasmdemo, bloomCache_ShouldEvictLeastRecentlyUsedUnreferencedFilters) {
+  const uint32_t BITMAP_LENGTH = 1000;
+  const std::vector<int8_t> bitmaps[] = {
+    testBitmap(BITMAP_LENGTH, 1),
+    testBitmap(BITMAP_LENGTH, 2),
+    testBitmap(BITMAP_LENGTH, 3),
+    testBitmap(BITMAP_LENGTH, 4),
+  };
+  const auto memoryUsage = static_cast<size_t>(BloomFilter::storageSizeFor(BITMAP_LENGTH));
+  // Room for three filters.
+  BloomFilterCache cache(memoryUsage * 3);
+  const auto insert = [&cache, &bitmaps](int i) {
+    return cache.insert(reinterpret_cast<const uint8_t*>(bitmaps[i].data()), BITMAP_LENGTH, 0, 7);
+  };
+  const auto lookup = [&cache, &bitmaps](int i) {
+    return cache.lookup(reinterpret_cast<const uint8_t*>(bitmaps[i].data()), BITMAP_LENGTH, 0, 7);
+  };
+
+  for (int i = 0; i < 3; i++) {
+    cache.release(insert(i));
+  }
+  EXPECT_EQ(cache.filterCount(), 3u);
+  EXPECT_EQ(cache.memoryUsage(), memoryUsage * 3);
+
+  // Using filter 0 makes filter 1 the least recently used one, which the
+  // fourth filter replaces.
+  cache.release(lookup(0));
+  cache.release(insert(3));
+  EXPECT_EQ(cache.filterCount(), 3u);
+  EXPECT_EQ(lookup(1), nullptr);
+  BloomFilter* filter0 = lookup(0);
+  BloomFilter* filter2 = lookup(2);
+  BloomFilter* filter3 = lookup(3);
+  EXPECT_NE(filter0, nullptr);
+  EXPECT_NE(filter2, nullptr);
+  EXPECT_NE(filter3, nullptr);
+
+  // Filters that are in use are kept even when they do not fit; the cache
+  // shrinks back to its budget as they are released.
+  BloomFilter* filter1 = insert(1);
+  EXPECT_EQ(cache.filterCount(), 4u);
+  EXPECT_EQ(cache.memoryUsage(), memoryUsage * 4);
+  cache.release(filter0);
+  EXPECT_EQ(cache.filterCount(), 3u);
+  EXPECT_EQ(lookup(0), nullptr);
+  cache.release(filter1);
+  cache.release(filter2);
+  cache.release(filter3);
+  EXPECT_EQ(cache.filterCount(), 3u);
+
+  // A cache without room for any filter keeps them only while they are used.
+  BloomFilterCache emptyCache(0);
+  BloomFilter* filter = emptyCache.insert(reinterpret_cast<const uint8_t*>(bitmaps[0].data()), BITMAP_LENGTH, 0, 7);
+  EXPECT_EQ(emptyCache.filterCount(), 1u);
+  emptyCache.release(filter);
+  EXPECT_EQ(emptyCache.filterCount(), 0u);
+}
+
+} // namespace
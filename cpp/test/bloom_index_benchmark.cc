@@ -0,0 +1,145 @@
+// Measures the cost of mapping a key's hashes onto bit indexes in BloomFilter,
+// for each of the golden test filter sizes that are shared with demo-website.
+//
+// The keys are hashed up front, so that only the index computations and bitmap
+// lookups are timed. "64-bit %" is the straightforward implementation, which
+// reduces each of the hashCount values h1 + i * h2 with a 64-bit modulo, and is
+// what BloomFilter did before FastModulo. "fast modulo" is BloomFilter with
+// IndexMapping::Modulo, whose results must be identical, and "multiply-shift"
+// is BloomFilter with IndexMapping::MultiplyShift; its results are not
+// meaningful for the golden filters, only its cost.
+//
+// Usage: wasmdemo_bloom_index_benchmark <golden_test_data_dir>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "wasmdemo/bloom.h"
+#include "wasmdemo/hash.h"
+
+#include "golden_test_data.h"
+
+namespace {
+
+// Each iteration probes the hashes repeatedly until it has done at least this
+// many probes, so that the small filters are timed over more than a few keys.
+const size_t MIN_PROBES_PER_ITERATION = 1000000;
+
+bool divisionMightContainHash(const GoldenTest& test, uint64_t size, const uint8_t* md5Hash) {
+  uint64_t hash1;
+  uint64_t hash2;
+  std::memcpy(&hash1, md5Hash, sizeof(hash1));
+  std::memcpy(&hash2, md5Hash + sizeof(hash1), sizeof(hash2));
+
+  for (int32_t i = 0; i < test.hashCount; i++) {
+    const uint64_t index = (hash1 + static_cast<uint64_t>(i) * hash2) % size;
+    if ((test.bitmap[index / 8] & (0x01 << (index % 8))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs `probe(md5Hash)` on every hash, BENCHMARK_RUN_COUNT times, storing the
+// results in `results`, and returns the fastest run's average nanoseconds per
+// probe.
+template <typename Probe>
+double timeProbes(const std::vector<uint8_t>& md5Hashes, std::vector<bool>& results, Probe probe) {
+  const size_t hashCount = md5Hashes.size() / 16;
+  const size_t roundCount = (MIN_PROBES_PER_ITERATION + hashCount - 1) / hashCount;
+  results.assign(hashCount, false);
+  const double bestNanos = timeBestOfRuns([&]() {
+    for (size_t round = 0; round < roundCount; round++) {
+      for (size_t i = 0; i < hashCount; i++) {
+        results[i] = probe(md5Hashes.data() + i * 16);
+      }
+    }
+  });
+  return bestNanos / static_cast<double>(roundCount * hashCount);
+}
+
+bool runBenchmark(const std::string& dir, const std::string& name) {
+  GoldenTest test;
+  if (!loadGoldenTest(dir, name, test)) {
+    return false;
+  }
+
+  const size_t keyCount = test.membershipTestResults.length();
+  std::vector<std::string> keys;
+  std::vector<const void*> keyData;
+  std::vector<unsigned int> keyLengths;
+  for (size_t i = 0; i < keyCount; i++) {
+    keys.push_back(GOLDEN_TEST_DOCUMENT_PREFIX + std::to_string(i));
+  }
+  for (const std::string& key : keys) {
+    keyData.push_back(key.data());
+    keyLengths.push_back(static_cast<unsigned int>(key.length()));
+  }
+  std::vector<uint8_t> md5Hashes(keyCount * 16);
+  MD5_Multi(keyData.data(), keyLengths.data(), static_cast<unsigned int>(keyCount), md5Hashes.data());
+
+  const uint32_t bitmapLength = static_cast<uint32_t>(test.bitmap.size());
+  const uint32_t padding = static_cast<uint32_t>(test.padding);
+  const uint32_t hashCount = static_cast<uint32_t>(test.hashCount);
+  const uint64_t size = bitmapLength * 8 - padding;
+  const auto* bitmap = reinterpret_cast<const uint8_t*>(test.bitmap.data());
+  BloomFilter moduloFilter(bitmap, bitmapLength, padding, hashCount);
+  BloomFilter multiplyShiftFilter(bitmap, bitmapLength, padding, hashCount,
+                                  BloomFilter::IndexMapping::MultiplyShift);
+
+  std::vector<bool> divisionResults, moduloResults, multiplyShiftResults;
+  const double divisionNanos = timeProbes(md5Hashes, divisionResults, [&](const uint8_t* md5Hash) {
+    return divisionMightContainHash(test, size, md5Hash);
+  });
+  const double moduloNanos = timeProbes(md5Hashes, moduloResults, [&](const uint8_t* md5Hash) {
+    return moduloFilter.mightContainHash(md5Hash);
+  });
+  const double multiplyShiftNanos = timeProbes(md5Hashes, multiplyShiftResults, [&](const uint8_t* md5Hash) {
+    return multiplyShiftFilter.mightContainHash(md5Hash);
+  });
+
+  std::printf("%s: size %llu, hashCount %u, %zu keys: 64-bit %% %.1f ns/probe, "
+              "fast modulo %.1f ns/probe (%.2fx), multiply-shift %.1f ns/probe (%.2fx)\n",
+              name.c_str(),
+              static_cast<unsigned long long>(size),
+              hashCount,
+              keyCount,
+              divisionNanos,
+              moduloNanos,
+              divisionNanos / moduloNanos,
+              multiplyShiftNanos,
+              divisionNanos / multiplyShiftNanos);
+
+  int mismatchCount = 0;
+  for (size_t i = 0; i < keyCount; i++) {
+    const bool expected = test.membershipTestResults[i] == '1';
+    if (divisionResults[i] != expected || moduloResults[i] != expected) {
+      mismatchCount++;
+    }
+  }
+  if (mismatchCount != 0) {
+    std::fprintf(stderr, "ERROR: %s: %d results did not match the golden test data\n",
+                 name.c_str(), mismatchCount);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "Usage: %s <golden_test_data_dir>\n", argv[0]);
+    return 2;
+  }
+  const std::string dir(argv[1]);
+
+  bool success = true;
+  success = runBenchmark(dir, "Validation_BloomFilterTest_MD5_1_0001") && success;
+  success = runBenchmark(dir, "Validation_BloomFilterTest_MD5_500_0001") && success;
+  success = runBenchmark(dir, "Validation_BloomFilterTest_MD5_5000_0001") && success;
+  success = runBenchmark(dir, "Validation_BloomFilterTest_MD5_50000_0001") && success;
+  return success ? 0 : 1;
+}
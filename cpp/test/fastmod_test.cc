@@ -0,0 +1,55 @@
+#include <cstdint>
+#include <vector>
+
+#include "wasmdemo/fastmod.h"
+
+#include "random_sequence.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Divisors that are likely to find mistakes: tiny ones, powers of two and their
+// neighbours, the largest ones, and the sizes of the golden test filters.
+const std::vector<uint32_t> interestingDivisors {
+  1, 2, 3, 5, 7, 8, 10, 255, 256, 257, 65535, 65536, 65537,
+  0x7fffffff, 0x80000000, 0x80000001, 0xfffffffe, 0xffffffff,
+  23, 9587, 95857, 479263, 958519,
+};
+
+const std::vector<uint64_t> interestingNumerators {
+  0, 1, 2, 0xffffffff, 0x100000000, 0x100000001,
+  0x7fffffffffffffff, 0x8000000000000000, 0xfffffffffffffffe, 0xffffffffffffffff,
+};
+
+TEST(wasmdemo, fastmod_ShouldMatchModuloForInterestingValues) {
+  for (uint32_t divisor : interestingDivisors) {
+    const FastModulo fastModulo(divisor);
+    EXPECT_EQ(fastModulo.divisor(), divisor);
+    for (uint64_t n : interestingNumerators) {
+      EXPECT_EQ(fastModulo.mod(n), n % divisor) << "n=" << n << " divisor=" << divisor;
+      EXPECT_EQ(fastModulo.mod(n - divisor), (n - divisor) % divisor) << "n=" << n << " divisor=" << divisor;
+      EXPECT_EQ(fastModulo.mod(n + divisor), (n + divisor) % divisor) << "n=" << n << " divisor=" << divisor;
+    }
+  }
+}
+
+TEST(wasmdemo, fastmod_ShouldMatchModuloForRandomValues) {
+  uint64_t state = 42;
+  std::vector<uint32_t> divisors = interestingDivisors;
+  for (int i = 0; i < 200; i++) {
+    // Random divisors of every bit length.
+    const uint32_t divisor = static_cast<uint32_t>(nextRandom(state) >> (32 + i % 32));
+    divisors.push_back(divisor == 0 ? 1 : divisor);
+  }
+
+  for (uint32_t divisor : divisors) {
+    const FastModulo fastModulo(divisor);
+    for (int i = 0; i < 1000; i++) {
+      const uint64_t n = nextRandom(state);
+      ASSERT_EQ(fastModulo.mod(n), n % divisor) << "n=" << n << " divisor=" << divisor;
+    }
+  }
+}
+
+} // namespace
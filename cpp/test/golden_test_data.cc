@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cstdio>
+#include <string_view>
+
+#include <dirent.h>
+
+#include "wasmdemo/base64.h"
+
+#include "golden_test_data.h"
+#include "json_scanner.h"
+
+const std::string GOLDEN_TEST_DOCUMENT_PREFIX =
+    "projects/project-1/databases/database-1/documents/coll/doc";
+
+namespace {
+
+const std::string_view BLOOM_FILTER_SUFFIX = "_bloom_filter_proto.json";
+
+} // namespace
+
+std::vector<std::string> listGoldenTests(const std::string& dir) {
+  std::vector<std::string> names;
+  DIR* directory = opendir(dir.c_str());
+  if (!directory) {
+    std::fprintf(stderr, "ERROR: unable to open directory: %s\n", dir.c_str());
+    return names;
+  }
+  while (const dirent* entry = readdir(directory)) {
+    const std::string_view fileName(entry->d_name);
+    if (fileName.length() > BLOOM_FILTER_SUFFIX.length() && fileName.ends_with(BLOOM_FILTER_SUFFIX)) {
+      names.emplace_back(fileName.substr(0, fileName.length() - BLOOM_FILTER_SUFFIX.length()));
+    }
+  }
+  closedir(directory);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+FILE* openGoldenTestFile(const std::string& dir, const std::string& name, const char* suffix) {
+  const std::string path = dir + "/" + name + suffix;
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (!file) {
+    std::fprintf(stderr, "ERROR: unable to open file: %s\n", path.c_str());
+  }
+  return file;
+}
+
+bool loadGoldenTestFilter(const std::string& dir, const std::string& name, GoldenTest& test) {
+  FILE* file = openGoldenTestFile(dir, name, BLOOM_FILTER_SUFFIX.data());
+  if (!file) {
+    return false;
+  }
+
+  // Decode the bitmap as it is read, rather than reading all of its base64
+  // text first.
+  test.bitmap.clear();
+  Base64Decoder decoder;
+  const auto decodeInto = [&test](size_t maxSize, auto decode) {
+    const size_t start = test.bitmap.size();
+    test.bitmap.resize(start + maxSize);
+    const size_t size = decode(reinterpret_cast<unsigned char*>(test.bitmap.data() + start));
+    test.bitmap.resize(start + size);
+  };
+  JsonScanner scanner(file);
+  int64_t padding = 0;
+  int64_t hashCount = 0;
+  bool success = scanner.findKey("bitmap") && scanner.readString([&](std::string_view piece) {
+    decodeInto(decoder.max_update_size(piece.length()), [&](unsigned char* dest) { return decoder.update(piece, dest); });
+  });
+  decodeInto(2, [&](unsigned char* dest) { return decoder.finish(dest); });
+  success = success && scanner.findKey("padding") && scanner.readInt(padding);
+  success = success && scanner.findKey("hashCount") && scanner.readInt(hashCount);
+  success = success && !scanner.hasError();
+  std::fclose(file);
+
+  test.padding = static_cast<int32_t>(padding);
+  test.hashCount = static_cast<int32_t>(hashCount);
+  if (!success || test.bitmap.empty() || padding < 0 || padding > 7 || hashCount <= 0 || hashCount > INT32_MAX) {
+    std::fprintf(stderr, "ERROR: invalid golden test data: %s\n", name.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool loadGoldenTest(const std::string& dir, const std::string& name, GoldenTest& test) {
+  if (!loadGoldenTestFilter(dir, name, test)) {
+    return false;
+  }
+
+  test.membershipTestResults.clear();
+  const bool success = readGoldenTestResults(dir, name, [&test](std::string_view piece) {
+    test.membershipTestResults.append(piece);
+  });
+  if (success && test.membershipTestResults.empty()) {
+    std::fprintf(stderr, "ERROR: invalid golden test data: %s\n", name.c_str());
+    return false;
+  }
+  return success;
+}
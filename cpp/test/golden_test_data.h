@@ -0,0 +1,87 @@
+#ifndef WASMDEMO_CPP_TEST_GOLDEN_TEST_DATA_H_
+#define WASMDEMO_CPP_TEST_GOLDEN_TEST_DATA_H_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "json_scanner.h"
+
+// The prefix of the keys in the golden test data; key i is this prefix
+// followed by i.
+extern const std::string GOLDEN_TEST_DOCUMENT_PREFIX;
+
+// A bloom filter and the expected membership test results from the golden test
+// data files that are shared with demo-website.
+struct GoldenTest {
+  std::vector<int8_t> bitmap;
+  int32_t padding = 0;
+  int32_t hashCount = 0;
+  std::string membershipTestResults;
+};
+
+// Returns the names of the golden tests in the given directory (i.e. every
+// <name> with a <name>_bloom_filter_proto.json file), sorted. Returns an empty
+// vector, after printing an error to stderr, if the directory cannot be read.
+std::vector<std::string> listGoldenTests(const std::string& dir);
+
+// Loads the golden test with the given name (e.g.
+// "Validation_BloomFilterTest_MD5_50000_01") from the given directory.
+// Returns false, after printing an error to stderr, on failure.
+bool loadGoldenTest(const std::string& dir, const std::string& name, GoldenTest& test);
+
+// Like loadGoldenTest(), but only loads the filter, leaving
+// `test.membershipTestResults` empty.
+bool loadGoldenTestFilter(const std::string& dir, const std::string& name, GoldenTest& test);
+
+// Opens the file of the golden test with the given name that ends with
+// `suffix`. Returns null, after printing an error to stderr, on failure.
+FILE* openGoldenTestFile(const std::string& dir, const std::string& name, const char* suffix);
+
+// Streams the expected membership test results of the golden test with the
+// given name, one '1' or '0' per key, calling `visit(piece)` with consecutive
+// pieces of them. Returns false, after printing an error to stderr, on failure.
+template <typename Visit>
+bool readGoldenTestResults(const std::string& dir, const std::string& name, Visit visit) {
+  FILE* file = openGoldenTestFile(dir, name, "_membership_test_result.json");
+  if (!file) {
+    return false;
+  }
+  JsonScanner scanner(file);
+  bool success = scanner.findKey("membershipTestResults") && scanner.readString(visit);
+  success = success && !scanner.hasError();
+  std::fclose(file);
+  if (!success) {
+    std::fprintf(stderr, "ERROR: invalid golden test data: %s\n", name.c_str());
+  }
+  return success;
+}
+
+// The number of times that timeBestOfRuns() runs the code being benchmarked.
+const int BENCHMARK_RUN_COUNT = 5;
+
+// Returns how many nanoseconds have passed since `startTime`.
+inline double nanosecondsSince(std::chrono::steady_clock::time_point startTime) {
+  const auto elapsed = std::chrono::steady_clock::now() - startTime;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+// Calls `run()` BENCHMARK_RUN_COUNT times, and returns how many nanoseconds the
+// fastest call took.
+template <typename Run>
+double timeBestOfRuns(Run run) {
+  double bestNanos = 0;
+  for (int iteration = 0; iteration < BENCHMARK_RUN_COUNT; iteration++) {
+    const auto startTime = std::chrono::steady_clock::now();
+    run();
+    const double elapsedNanos = nanosecondsSince(startTime);
+    if (iteration == 0 || elapsedNanos < bestNanos) {
+      bestNanos = elapsedNanos;
+    }
+  }
+  return bestNanos;
+}
+
+#endif // WASMDEMO_CPP_TEST_GOLDEN_TEST_DATA_H_
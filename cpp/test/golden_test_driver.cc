@@ -0,0 +1,160 @@
+// Runs every golden test in a directory of golden test data, i.e. every pair of
+// <name>_bloom_filter_proto.json and <name>_membership_test_result.json files,
+// like the ones that are shared with demo-website. Both files are streamed
+// rather than read into memory, so the directory may also hold
+// production-sized filters, without them being compiled into any test.
+//
+// For each test, it reports how long loading the filter and probing its keys
+// took, and it fails if any result does not match the expected one.
+//
+// Usage: wasmdemo_golden_test_driver <golden_test_data_dir>
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "wasmdemo/bloom.h"
+
+#include "golden_test_data.h"
+
+namespace {
+
+// The number of keys that are probed with each mightContainBatch() call.
+const uint32_t PROBE_BATCH_KEY_COUNT = 4096;
+
+// Probes the golden test keys in batches as their expected results are added,
+// and counts the results that differ from the expected ones.
+class KeyProber {
+ public:
+  explicit KeyProber(BloomFilter& filter)
+      : _filter(filter),
+        _prefix(GOLDEN_TEST_DOCUMENT_PREFIX.data(), static_cast<uint32_t>(GOLDEN_TEST_DOCUMENT_PREFIX.length())),
+        _results((PROBE_BATCH_KEY_COUNT + 7) / 8) {
+    _offsets.push_back(0);
+  }
+
+  // Adds the next key, which is expected to be contained in the filter if
+  // `expected`.
+  void add(bool expected) {
+    char suffix[16];
+    const uint32_t keyIndex = _keyCount + static_cast<uint32_t>(_expected.size());
+    _suffixes.append(suffix, std::to_chars(suffix, suffix + sizeof(suffix), keyIndex).ptr);
+    _offsets.push_back(static_cast<uint32_t>(_suffixes.length()));
+    _expected.push_back(expected);
+    if (_expected.size() == PROBE_BATCH_KEY_COUNT) {
+      flush();
+    }
+  }
+
+  // Probes the keys that have been added since the last flush().
+  void flush() {
+    const uint32_t keyCount = static_cast<uint32_t>(_expected.size());
+    const auto startTime = std::chrono::steady_clock::now();
+    _positiveCount += _filter.mightContainBatch(_prefix, _suffixes.data(), _offsets.data(), keyCount, _results.data());
+    _probeNanos += nanosecondsSince(startTime);
+
+    for (uint32_t i = 0; i < keyCount; i++) {
+      const bool result = (_results[i / 8] >> (i % 8)) & 0x01;
+      if (result != _expected[i]) {
+        _mismatchCount++;
+      }
+    }
+    _keyCount += keyCount;
+    _suffixes.clear();
+    _offsets.resize(1);
+    _expected.clear();
+  }
+
+  uint32_t keyCount() const {
+    return _keyCount;
+  }
+  uint32_t positiveCount() const {
+    return _positiveCount;
+  }
+  uint32_t mismatchCount() const {
+    return _mismatchCount;
+  }
+  double probeNanos() const {
+    return _probeNanos;
+  }
+
+ private:
+  BloomFilter& _filter;
+  const KeyPrefix _prefix;
+  std::string _suffixes;
+  std::vector<uint32_t> _offsets;
+  std::vector<bool> _expected;
+  std::vector<uint8_t> _results;
+  uint32_t _keyCount = 0;
+  uint32_t _positiveCount = 0;
+  uint32_t _mismatchCount = 0;
+  double _probeNanos = 0;
+};
+
+bool runGoldenTest(const std::string& dir, const std::string& name) {
+  const auto loadStartTime = std::chrono::steady_clock::now();
+  GoldenTest test;
+  if (!loadGoldenTestFilter(dir, name, test)) {
+    return false;
+  }
+  BloomFilter* bloomFilter = newBloomFilter(
+      test.bitmap.data(),
+      static_cast<int32_t>(test.bitmap.size()),
+      test.padding,
+      test.hashCount);
+  const double loadNanos = nanosecondsSince(loadStartTime);
+
+  KeyProber prober(*bloomFilter);
+  const bool success = readGoldenTestResults(dir, name, [&prober](std::string_view piece) {
+    for (char expected : piece) {
+      prober.add(expected == '1');
+    }
+  });
+  prober.flush();
+  deleteBloomFilter(bloomFilter);
+  if (!success) {
+    return false;
+  }
+
+  const uint64_t size = test.bitmap.size() * 8 - static_cast<uint64_t>(test.padding);
+  std::printf("%s: size %llu, hashCount %d, %u keys (%u positive): load %.2f ms, probe %.1f ns/key\n",
+              name.c_str(),
+              static_cast<unsigned long long>(size),
+              test.hashCount,
+              prober.keyCount(),
+              prober.positiveCount(),
+              loadNanos / 1e6,
+              prober.keyCount() == 0 ? 0.0 : prober.probeNanos() / prober.keyCount());
+
+  if (prober.mismatchCount() != 0) {
+    std::fprintf(stderr, "ERROR: %s: %u results did not match the golden test data\n",
+                 name.c_str(), prober.mismatchCount());
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "Usage: %s <golden_test_data_dir>\n", argv[0]);
+    return 2;
+  }
+  const std::string dir(argv[1]);
+
+  const std::vector<std::string> names = listGoldenTests(dir);
+  if (names.empty()) {
+    std::fprintf(stderr, "ERROR: no golden tests in %s\n", dir.c_str());
+    return 1;
+  }
+
+  bool success = true;
+  for (const std::string& name : names) {
+    success = runGoldenTest(dir, name) && success;
+  }
+  return success ? 0 : 1;
+}
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "wasmdemo/hash.h"
 
@@ -81,7 +84,7 @@ TEST(wasmdemo, hash_ShouldHaveExpectedLongStringHash) {
   EXPECT_EQ(hash_result_hex, "B2EA9F7FCEA831A4A63B213F41A8855B");
 }
 
-// `hash` is backed by a struct that is shared between function calls.
+// `hash` writes to a buffer that is shared between function calls.
 // If hash is buggy, old hashes could affect new ones.
 TEST(wasmdemo, hash_ShouldHaveExpectedHashAfterPreviousDifferentHash) {
   unsigned char* unusedHash = hash("abc", 3);
@@ -95,4 +98,147 @@ TEST(wasmdemo, hash_ShouldHaveExpectedHashAfterPreviousDifferentHash) {
   EXPECT_EQ(hash_result_hex, "B2EA9F7FCEA831A4A63B213F41A8855B");
 }
 
+// Computes the MD5 digest of the given data with MD5_Init/MD5_Update/MD5_Final.
+std::string hex_digest_from_md5_final(const unsigned char* data, unsigned int size) {
+  unsigned char result[16];
+  MD5_CTX ctx;
+  MD5_Init(&ctx);
+  MD5_Update(&ctx, data, size);
+  MD5_Final(result, &ctx);
+  return hex_digest_from_hash_result(result);
+}
+
+TEST(wasmdemo, MD5_Multi_ShouldMatchMD5FinalForAllShortLengths) {
+  // Every length up to 300 covers one-, two-, and many-block messages, as well
+  // as lengths that are hashed by the scalar fallback.
+  const unsigned int count = 301;
+  std::vector<unsigned char> data(count);
+  for (unsigned int i = 0; i < count; i++) {
+    data[i] = static_cast<unsigned char>(i * 7 + 3);
+  }
+  std::vector<const void*> messages;
+  std::vector<unsigned int> sizes;
+  for (unsigned int i = 0; i < count; i++) {
+    messages.push_back(data.data());
+    sizes.push_back(i);
+  }
+  std::vector<unsigned char> results(count * 16);
+
+  MD5_Multi(messages.data(), sizes.data(), count, results.data());
+
+  for (unsigned int i = 0; i < count; i++) {
+    EXPECT_EQ(hex_digest_from_hash_result(&results[i * 16]),
+              hex_digest_from_md5_final(data.data(), i)) << "size=" << i;
+  }
+}
+
+TEST(wasmdemo, MD5_Multi_ShouldMatchMD5FinalForEveryBatchSize) {
+  const std::string prefix =
+      "projects/project-1/databases/database-1/documents/coll/doc";
+  for (unsigned int count = 0; count <= 40; count++) {
+    std::vector<std::string> keys;
+    for (unsigned int i = 0; i < count; i++) {
+      // Mix in a long message so that it is hashed out of lane order.
+      keys.push_back(i == 5 ? std::string(1000, 'x') : prefix + std::to_string(i));
+    }
+    std::vector<const void*> messages;
+    std::vector<unsigned int> sizes;
+    for (const std::string& key : keys) {
+      messages.push_back(key.data());
+      sizes.push_back(static_cast<unsigned int>(key.length()));
+    }
+    std::vector<unsigned char> results(count * 16);
+
+    MD5_Multi(messages.data(), sizes.data(), count, results.data());
+
+    for (unsigned int i = 0; i < count; i++) {
+      EXPECT_EQ(hex_digest_from_hash_result(&results[i * 16]),
+                hex_digest_from_md5_final(
+                    reinterpret_cast<const unsigned char*>(keys[i].data()), sizes[i]))
+          << "count=" << count << " i=" << i;
+    }
+  }
+}
+
+TEST(wasmdemo, MD5_Multi_Prefixed_ShouldMatchMD5FinalOfConcatenation) {
+  std::vector<unsigned char> data(400);
+  for (unsigned int i = 0; i < data.size(); i++) {
+    data[i] = static_cast<unsigned char>(i * 13 + 5);
+  }
+
+  // Prefixes with no, some, and exactly one block compressed, and with empty,
+  // partial, and almost full buffers; and suffixes of every length that mixes
+  // lane and scalar hashing.
+  for (unsigned int prefixSize : {0u, 1u, 55u, 63u, 64u, 65u, 100u, 127u, 128u, 130u}) {
+    MD5_CTX prefix;
+    MD5_Init(&prefix);
+    MD5_Update(&prefix, data.data(), prefixSize);
+
+    const unsigned int count = 270;
+    std::vector<const void*> suffixes;
+    std::vector<unsigned int> sizes;
+    for (unsigned int i = 0; i < count; i++) {
+      suffixes.push_back(data.data() + prefixSize);
+      sizes.push_back(i);
+    }
+    std::vector<unsigned char> results(count * 16);
+
+    MD5_Multi_Prefixed(&prefix, suffixes.data(), sizes.data(), count, results.data());
+
+    for (unsigned int i = 0; i < count; i++) {
+      ASSERT_EQ(hex_digest_from_hash_result(&results[i * 16]),
+                hex_digest_from_md5_final(data.data(), prefixSize + i))
+          << "prefixSize=" << prefixSize << " size=" << i;
+    }
+  }
+}
+
+
+TEST(wasmdemo, hashMulti_ShouldMatchMD5FinalOfEachInput) {
+  for (int32_t count : {0, 1, 63, 64, 65, 200}) {
+    std::string data;
+    std::vector<int32_t> offsets {0};
+    for (int32_t i = 0; i < count; i++) {
+      // Lengths from empty up to several blocks, which are hashed differently.
+      data += std::string(static_cast<size_t>(i * 37 % 300), static_cast<char>('a' + i % 26));
+      offsets.push_back(static_cast<int32_t>(data.length()));
+    }
+    std::vector<unsigned char> results(static_cast<size_t>(count) * 16);
+
+    hashMulti(data.data(), offsets.data(), count, results.data());
+
+    for (int32_t i = 0; i < count; i++) {
+      const size_t start = static_cast<size_t>(offsets[static_cast<size_t>(i)]);
+      const size_t end = static_cast<size_t>(offsets[static_cast<size_t>(i) + 1]);
+      ASSERT_EQ(hex_digest_from_hash_result(&results[static_cast<size_t>(i) * 16]),
+                hex_digest_from_md5_final(reinterpret_cast<const unsigned char*>(data.data()) + start,
+                                          static_cast<unsigned int>(end - start)))
+          << "count=" << count << " i=" << i;
+    }
+  }
+}
+
+TEST(wasmdemo, hashUpdate_ShouldMatchOneShotHashForAnyChunking) {
+  std::vector<char> data(10000);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<char>(i * 31 + 7);
+  }
+  const std::string expected = hex_digest_from_md5_final(
+      reinterpret_cast<const unsigned char*>(data.data()), static_cast<unsigned int>(data.size()));
+
+  // The caller owns the context; any suitably aligned memory will do.
+  std::vector<uint64_t> contextStorage((static_cast<size_t>(hashContextSize()) + 7) / 8);
+  auto* context = reinterpret_cast<MD5_CTX*>(contextStorage.data());
+  for (size_t chunkSize : {1u, 7u, 63u, 64u, 65u, 1000u, 10000u}) {
+    hashInit(context);
+    for (size_t start = 0; start < data.size(); start += chunkSize) {
+      const size_t size = std::min(chunkSize, data.size() - start);
+      hashUpdate(context, data.data() + start, static_cast<int32_t>(size));
+    }
+    unsigned char result[16];
+    hashFinal(context, result);
+    EXPECT_EQ(hex_digest_from_hash_result(result), expected) << "chunkSize=" << chunkSize;
+  }
+}
+
 } // namespace
@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <cstring>
+
+#include "json_scanner.h"
+
+namespace {
+
+bool isJsonWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+} // namespace
+
+bool JsonScanner::findKey(std::string_view key) {
+  while (fill()) {
+    // Skip to the start of the next string.
+    const void* quote = std::memchr(_buffer + _position, '"', _end - _position);
+    if (!quote) {
+      _position = _end;
+      continue;
+    }
+    _position = static_cast<size_t>(static_cast<const char*>(quote) - _buffer) + 1;
+
+    // Compare the string with `key` as it goes by, which may be across several
+    // buffers, then check whether it is an object key.
+    size_t length = 0;
+    bool matches = true;
+    for (bool escaped = false;; length++) {
+      if (!fill()) {
+        return false;
+      }
+      const char c = _buffer[_position++];
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+        matches = false;
+      } else if (c == '"') {
+        break;
+      }
+      matches = matches && length < key.length() && key[length] == c;
+    }
+    if (matches && length == key.length() && consume(':')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool JsonScanner::readInt(int64_t& value) {
+  const bool negative = consume('-');
+  int64_t magnitude = 0;
+  size_t digitCount = 0;
+  while (fill() && _buffer[_position] >= '0' && _buffer[_position] <= '9') {
+    const int64_t digit = _buffer[_position] - '0';
+    if (magnitude > (INT64_MAX - digit) / 10) {
+      return false;
+    }
+    magnitude = magnitude * 10 + digit;
+    _position++;
+    digitCount++;
+  }
+  if (digitCount == 0) {
+    return false;
+  }
+  value = negative ? -magnitude : magnitude;
+  return true;
+}
+
+bool JsonScanner::fill() {
+  if (_position < _end) {
+    return true;
+  }
+  _position = 0;
+  _end = std::fread(_buffer, 1, sizeof(_buffer), _file);
+  return _end != 0;
+}
+
+bool JsonScanner::consume(char c) {
+  while (fill()) {
+    const char next = _buffer[_position];
+    if (!isJsonWhitespace(next)) {
+      if (next != c) {
+        return false;
+      }
+      _position++;
+      return true;
+    }
+    _position++;
+  }
+  return false;
+}
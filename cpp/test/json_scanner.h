@@ -0,0 +1,82 @@
+#ifndef WASMDEMO_CPP_TEST_JSON_SCANNER_H_
+#define WASMDEMO_CPP_TEST_JSON_SCANNER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+// Reads the values of keys from a JSON file through a fixed-size buffer, so
+// that a file of any size is scanned without allocating memory. This is not a
+// general-purpose parser: findKey() skips ahead to the next object key with the
+// given name, wherever it is nested, so keys must be looked up in the order in
+// which they appear in the file, and strings must not contain escapes. That is
+// all that the golden test data files need.
+class JsonScanner {
+ public:
+  // Scans `file`, which the caller closes.
+  explicit JsonScanner(FILE* file) : _file(file) {
+  }
+
+  JsonScanner(const JsonScanner&) = delete;
+  JsonScanner& operator=(const JsonScanner&) = delete;
+
+  // Skips past the next object key named `key` and its colon. Returns false if
+  // the end of the file comes first. `key` must not contain escapes either.
+  bool findKey(std::string_view key);
+
+  // Reads the string value at the current position, calling `visit(piece)` with
+  // consecutive pieces of its contents, which are only valid during the call.
+  // Returns false if the value is not a string without escapes.
+  template <typename Visit>
+  bool readString(Visit visit);
+
+  // Reads the integer value at the current position. Returns false if there is
+  // none, or if it does not fit.
+  bool readInt(int64_t& value);
+
+  // Whether reading the file failed, as opposed to reaching its end.
+  bool hasError() const {
+    return std::ferror(_file) != 0;
+  }
+
+ private:
+  FILE* _file;
+  char _buffer[4096];
+  size_t _position = 0;
+  size_t _end = 0;
+
+  // Refills the buffer if it has been consumed. Returns false at the end of the
+  // file.
+  bool fill();
+
+  // Skips whitespace, then consumes `c` if it is the next character.
+  bool consume(char c);
+};
+
+template <typename Visit>
+bool JsonScanner::readString(Visit visit) {
+  if (!consume('"')) {
+    return false;
+  }
+  while (fill()) {
+    const std::string_view rest(_buffer + _position, _end - _position);
+    const size_t length = std::min(rest.find('"'), rest.length());
+    const std::string_view piece = rest.substr(0, length);
+    if (piece.find('\\') != std::string_view::npos) {
+      return false;
+    }
+    if (!piece.empty()) {
+      visit(piece);
+    }
+    _position += length;
+    if (length < rest.length()) {
+      _position++;
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif // WASMDEMO_CPP_TEST_JSON_SCANNER_H_
@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <string>
+
+#include "wasmdemo/logging.h"
+
+#include "wasmdemo_imports_impl.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using testing::ElementsAre;
+using testing::SizeIs;
+
+// Restores the default log level when a test that changes it ends.
+class LogLevelResetter {
+ public:
+  ~LogLevelResetter() {
+    setLogLevel(0);
+  }
+};
+
+TEST(wasmdemo, writeLog_ShouldBufferLinesUntilFlushed) {
+  if (!isLogLevelCompiledIn(LogLevel::Info)) {
+    GTEST_SKIP() << "Info messages are compiled out";
+  }
+  LogCallCapturer log_call_capturer;
+  writeLog(LogLevel::Info, "first");
+  writeLog(LogLevel::Warning, "second");
+  EXPECT_THAT(log_call_capturer.calls(), SizeIs(0));
+
+  flushLog();
+  EXPECT_THAT(log_call_capturer.calls(), ElementsAre(std::string("INFO: first\nWARNING: second\n")));
+
+  flushLog();
+  EXPECT_THAT(log_call_capturer.calls(), SizeIs(1));
+}
+
+TEST(wasmdemo, writeLog_ShouldFlushErrorsRightAway) {
+  if (!isLogLevelCompiledIn(LogLevel::Info)) {
+    GTEST_SKIP() << "Info messages are compiled out";
+  }
+  LogCallCapturer log_call_capturer;
+  writeLog(LogLevel::Info, "before");
+  writeLog(LogLevel::Error, "failed");
+  EXPECT_THAT(log_call_capturer.calls(), ElementsAre(std::string("INFO: before\nERROR: failed\n")));
+}
+
+TEST(wasmdemo, writeLog_ShouldFlushInBatchesWhenTheBufferIsFull) {
+  if (!isLogLevelCompiledIn(LogLevel::Info)) {
+    GTEST_SKIP() << "Info messages are compiled out";
+  }
+  LogCallCapturer log_call_capturer;
+  const std::string message(100, 'x');
+  for (int i = 0; i < 100; i++) {
+    writeLog(LogLevel::Info, message);
+  }
+  const size_t callCount = log_call_capturer.calls().size();
+  EXPECT_GE(callCount, 2u);
+  EXPECT_LT(callCount, 10u);
+
+  const std::vector<std::string> lines = log_call_capturer.lines();
+  ASSERT_THAT(lines, SizeIs(100));
+  for (const std::string& line : lines) {
+    EXPECT_EQ(line, "INFO: " + message);
+  }
+}
+
+TEST(wasmdemo, writeLog_ShouldTruncateLinesLongerThanTheBuffer) {
+  if (!isLogLevelCompiledIn(LogLevel::Info)) {
+    GTEST_SKIP() << "Info messages are compiled out";
+  }
+  LogCallCapturer log_call_capturer;
+  writeLog(LogLevel::Info, std::string(100000, 'x'));
+  const std::vector<std::string> lines = log_call_capturer.lines();
+  ASSERT_THAT(lines, SizeIs(1));
+  EXPECT_LT(lines[0].length(), 100000u);
+  EXPECT_EQ(lines[0].substr(0, 7), "INFO: x");
+}
+
+TEST(wasmdemo, setLogLevel_ShouldDropLowerLevels) {
+  if (!isLogLevelCompiledIn(LogLevel::Warning)) {
+    GTEST_SKIP() << "Warning messages are compiled out";
+  }
+  LogLevelResetter log_level_resetter;
+  LogCallCapturer log_call_capturer;
+  setLogLevel(static_cast<int32_t>(LogLevel::Warning));
+  writeLog(LogLevel::Info, "dropped");
+  writeLog(LogLevel::Warning, "kept");
+  setLogLevel(4);
+  writeLog(LogLevel::Error, "dropped too");
+  EXPECT_THAT(log_call_capturer.lines(), ElementsAre(std::string("WARNING: kept")));
+}
+
+TEST(wasmdemo, LogLine_ShouldFormatTextAndIntegers) {
+  LogLine line;
+  line << "size " << uint32_t{958519} << ", delta " << int64_t{-42};
+  EXPECT_EQ(line.text(), "size 958519, delta -42");
+
+  LogLine longLine;
+  for (int i = 0; i < 100; i++) {
+    longLine << "abcd";
+  }
+  EXPECT_EQ(longLine.text().length(), LogLine::CAPACITY);
+}
+
+TEST(wasmdemo, WASMDEMO_LOG_ShouldNotEvaluateCompiledOutMessages) {
+  LogCallCapturer log_call_capturer;
+  int evaluationCount = 0;
+  const auto message = [&evaluationCount]() {
+    evaluationCount++;
+    return LogLine() << "evaluated";
+  };
+  WASMDEMO_LOG(Debug, message());
+  WASMDEMO_LOG(Error, message());
+  EXPECT_EQ(evaluationCount, (isLogLevelCompiledIn(LogLevel::Debug) ? 1 : 0) + (isLogLevelCompiledIn(LogLevel::Error) ? 1 : 0));
+  EXPECT_THAT(log_call_capturer.lines(), SizeIs(evaluationCount));
+}
+
+} // namespace
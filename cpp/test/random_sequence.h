@@ -0,0 +1,15 @@
+#ifndef WASMDEMO_CPP_TEST_RANDOM_SEQUENCE_H_
+#define WASMDEMO_CPP_TEST_RANDOM_SEQUENCE_H_
+
+#include <cstdint>
+
+// A deterministic sequence of pseudorandom 64-bit numbers (splitmix64), for
+// tests and benchmarks that need arbitrary but reproducible values.
+inline uint64_t nextRandom(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+#endif // WASMDEMO_CPP_TEST_RANDOM_SEQUENCE_H_
@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "wasmdemo/sparse_bitmap.h"
+
+#include "random_sequence.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+bool isBitSet(const std::vector<uint8_t>& bitmap, uint64_t n) {
+  return (bitmap[n / 8] & (0x01 << (n % 8))) != 0;
+}
+
+TEST(wasmdemo, sparseBitmap_ShouldMatchDenseBitmap) {
+  uint64_t state = 3;
+  // Sizes around the container size, and the size of the largest golden filter.
+  for (uint64_t bitCount : {65535u, 65536u, 65537u, 200000u, 958519u}) {
+    // Set a few random bits, plus the first and the last one, and set every
+    // bit of the padding, which must be ignored.
+    std::vector<uint8_t> bitmap((bitCount + 7) / 8);
+    for (uint64_t n = bitCount; n < bitmap.size() * 8; n++) {
+      bitmap[n / 8] = static_cast<uint8_t>(bitmap[n / 8] | (0x01 << (n % 8)));
+    }
+    for (uint64_t n : {uint64_t{0}, bitCount - 1}) {
+      bitmap[n / 8] = static_cast<uint8_t>(bitmap[n / 8] | (0x01 << (n % 8)));
+    }
+    for (int i = 0; i < 100; i++) {
+      const uint64_t n = nextRandom(state) % bitCount;
+      bitmap[n / 8] = static_cast<uint8_t>(bitmap[n / 8] | (0x01 << (n % 8)));
+    }
+
+    const std::unique_ptr<SparseBitmap> sparseBitmap(SparseBitmap::createIfSmaller(bitmap.data(), bitCount));
+    ASSERT_NE(sparseBitmap, nullptr) << "bitCount=" << bitCount;
+    EXPECT_LE(sparseBitmap->memoryUsage() * 4, bitmap.size()) << "bitCount=" << bitCount;
+
+    uint64_t setBitCount = 0;
+    for (uint64_t n = 0; n < bitCount; n++) {
+      ASSERT_EQ(sparseBitmap->isBitSet(n), isBitSet(bitmap, n)) << "bitCount=" << bitCount << " n=" << n;
+      setBitCount += isBitSet(bitmap, n) ? 1 : 0;
+    }
+    EXPECT_EQ(sparseBitmap->setBitCount(), setBitCount) << "bitCount=" << bitCount;
+  }
+}
+
+TEST(wasmdemo, sparseBitmap_ShouldNotBeCreatedUnlessMuchSmaller) {
+  // Too small for the containers to pay off, even when empty.
+  const std::vector<uint8_t> smallBitmap(16);
+  EXPECT_EQ(SparseBitmap::createIfSmaller(smallBitmap.data(), 128), nullptr);
+  EXPECT_EQ(SparseBitmap::createIfSmaller(nullptr, 0), nullptr);
+
+  // One bit in 64 is more than a quarter of the size of the dense bitmap.
+  const uint64_t bitCount = 1 << 20;
+  std::vector<uint8_t> bitmap(bitCount / 8);
+  for (uint64_t n = 0; n < bitCount; n += 64) {
+    bitmap[n / 8] = 0x01;
+  }
+  EXPECT_EQ(SparseBitmap::createIfSmaller(bitmap.data(), bitCount), nullptr);
+
+  // Half as many bits fit.
+  for (uint64_t n = 64; n < bitCount; n += 128) {
+    bitmap[n / 8] = 0;
+  }
+  const std::unique_ptr<SparseBitmap> sparseBitmap(SparseBitmap::createIfSmaller(bitmap.data(), bitCount));
+  ASSERT_NE(sparseBitmap, nullptr);
+  EXPECT_EQ(sparseBitmap->setBitCount(), bitCount / 128);
+}
+
+} // namespace
@@ -0,0 +1,89 @@
+#include <cstdint>
+#include <numeric>
+#include <string>
+
+#include "wasmdemo/allocator.h"
+#include "wasmdemo/base64.h"
+#include "wasmdemo/bloom.h"
+#include "wasmdemo/hash.h"
+#include "wasmdemo/stats.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string documentPrefix =
+    "projects/project-1/databases/database-1/documents/coll/doc";
+
+uint64_t negativeProbeCount(const WasmdemoStats& stats) {
+  return std::accumulate(std::begin(stats.bloomNegativeProbeDepths), std::end(stats.bloomNegativeProbeDepths), uint64_t{0});
+}
+
+// Probes a filter built with newBloomFilterFromBase64 for 100 documents, of
+// which only documents 0 and 1 were inserted.
+void probeBase64Filter() {
+  // { "bits": { "bitmap": "RswZ", "padding": 1 }, "hashCount": 16 }
+  BloomFilter* const filter = newBloomFilterFromBase64("RswZ", 4, 1, 16);
+  for (int i = 0; i < 100; i++) {
+    const std::string document = documentPrefix + std::to_string(i);
+    mightContain(filter, document.c_str(), static_cast<int32_t>(document.length()));
+  }
+  deleteBloomFilter(filter);
+}
+
+TEST(wasmdemo, readStats_ShouldReturnTheVersion) {
+  const WasmdemoStats* const stats = readStats();
+  EXPECT_EQ(stats->version, WASMDEMO_STATS_VERSION);
+  EXPECT_EQ(stats->enabled, WASMDEMO_STATS ? 1u : 0u);
+}
+
+TEST(wasmdemo, readStats_ShouldCountBloomFilterProbes) {
+  resetStats();
+  probeBase64Filter();
+  const WasmdemoStats stats = *readStats();
+  if (!WASMDEMO_STATS) {
+    EXPECT_EQ(stats.bloomFiltersCreated, 0u);
+    EXPECT_EQ(stats.bloomProbes, 0u);
+    EXPECT_EQ(negativeProbeCount(stats), 0u);
+    return;
+  }
+  EXPECT_EQ(stats.bloomFiltersCreated, 1u);
+  EXPECT_EQ(stats.bloomProbes, 100u);
+  EXPECT_GE(stats.bloomPositives, 1u);
+  EXPECT_LT(stats.bloomPositives, 100u);
+  EXPECT_EQ(negativeProbeCount(stats), stats.bloomProbes - stats.bloomPositives);
+  EXPECT_EQ(stats.base64DecodedBytes, 3u);
+}
+
+TEST(wasmdemo, readStats_ShouldCountHashedBlocksAndAllocations) {
+  resetStats();
+  const std::string input(1000, 'x');
+  hash(input.data(), static_cast<unsigned int>(input.length()));
+  void* const block = my_wasm_malloc(100);
+  const WasmdemoStats stats = *readStats();
+  my_wasm_free(block);
+  if (!WASMDEMO_STATS) {
+    EXPECT_EQ(stats.md5Blocks, 0u);
+    EXPECT_EQ(stats.allocations, 0u);
+    return;
+  }
+  // 15 whole blocks, and one for the last 40 bytes and the padding.
+  EXPECT_EQ(stats.md5Blocks, 16u);
+  EXPECT_GE(stats.allocations, 1u);
+  EXPECT_GE(stats.allocatedBytes, 100u);
+}
+
+TEST(wasmdemo, resetStats_ShouldClearTheCounters) {
+  probeBase64Filter();
+  resetStats();
+  const WasmdemoStats stats = *readStats();
+  EXPECT_EQ(stats.bloomFiltersCreated, 0u);
+  EXPECT_EQ(stats.bloomCreateNanos, 0u);
+  EXPECT_EQ(stats.bloomProbes, 0u);
+  EXPECT_EQ(negativeProbeCount(stats), 0u);
+  EXPECT_EQ(stats.base64DecodedBytes, 0u);
+  EXPECT_EQ(stats.base64DecodeNanos, 0u);
+  EXPECT_EQ(stats.version, WASMDEMO_STATS_VERSION);
+}
+
+} // namespace
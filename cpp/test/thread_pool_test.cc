@@ -0,0 +1,47 @@
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "wasmdemo/thread_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(wasmdemo, threadPool_parallelFor_ShouldRunEveryTaskOnce) {
+  for (uint32_t threadCount : {0u, 1u, 2u, 5u}) {
+    ThreadPool pool(threadCount);
+    EXPECT_GE(pool.threadCount(), 1u);
+
+    for (uint32_t taskCount : {0u, 1u, 2u, 7u, 1000u}) {
+      std::vector<std::atomic<int>> runCounts(taskCount);
+      pool.parallelFor(taskCount, [&](uint32_t i) { runCounts[i]++; });
+      for (uint32_t i = 0; i < taskCount; i++) {
+        EXPECT_EQ(runCounts[i], 1) << "threadCount=" << threadCount << " taskCount=" << taskCount << " i=" << i;
+      }
+    }
+  }
+}
+
+TEST(wasmdemo, threadPool_parallelFor_ShouldBeReusable) {
+  ThreadPool pool(4);
+  std::atomic<uint64_t> sum {0};
+  for (uint32_t round = 0; round < 500; round++) {
+    pool.parallelFor(round % 10, [&](uint32_t i) { sum += i + 1; });
+  }
+  // Each round of n tasks adds n * (n + 1) / 2, and every n < 10 occurs 50 times.
+  EXPECT_EQ(sum, 50u * (0 + 1 + 3 + 6 + 10 + 15 + 21 + 28 + 36 + 45));
+}
+
+TEST(wasmdemo, threadPool_withSharedThreadPool_ShouldUseRequestedThreadCount) {
+  withSharedThreadPool(3, [](ThreadPool& pool) {
+#if WASMDEMO_THREADS
+    EXPECT_EQ(pool.threadCount(), 3u);
+#else
+    EXPECT_EQ(pool.threadCount(), 1u);
+#endif
+  });
+  withSharedThreadPool(1, [](ThreadPool& pool) { EXPECT_EQ(pool.threadCount(), 1u); });
+}
+
+} // namespace
@@ -1,6 +1,8 @@
 #include <cstdlib>
 #include <iostream>
+#include <string_view>
 
+#include "wasmdemo/logging.h"
 #include "wasmdemo/wasmdemo.h"
 
 #include "wasmdemo_imports_impl.h"
@@ -27,6 +29,7 @@ LogCallCapturer::LogCallCapturer() {
       << ": gLogCallDest is already set" << std::endl;
     abort();
   }
+  flushLog();
   gLogCallDest = &calls_;
 }
 
@@ -38,3 +41,16 @@ LogCallCapturer::~LogCallCapturer() {
   }
   gLogCallDest = nullptr;
 }
+
+std::vector<std::string> LogCallCapturer::lines() {
+  flushLog();
+  std::vector<std::string> lines;
+  for (std::string_view call : calls_) {
+    while (!call.empty()) {
+      const size_t end = call.find('\n');
+      lines.emplace_back(call.substr(0, end));
+      call.remove_prefix(end == std::string_view::npos ? call.length() : end + 1);
+    }
+  }
+  return lines;
+}
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+// Captures the calls to the `log` import while it exists. Lines that were
+// buffered by writeLog() before it was created are dropped.
 class LogCallCapturer {
  public:
   LogCallCapturer();
@@ -13,6 +15,10 @@ class LogCallCapturer {
     return calls_;
   }
 
+  // Flushes the log buffer, then returns the captured calls split into lines,
+  // without their '\n'.
+  [[nodiscard]] std::vector<std::string> lines();
+
  private:
   std::vector<std::string> calls_;
 };
@@ -66,6 +66,15 @@ TEST(wasmdemo, log_ShouldCallTheImportedLogFunction) {
       std::string("abcdef")));
 }
 
+TEST(wasmdemo, echo_signed_unsigned_ShouldLogBothValues) {
+  LogCallCapturer log_call_capturer;
+  echo_signed_unsigned(0, 0);
+  echo_signed_unsigned(-2147483647 - 1, 4294967295u);
+  EXPECT_THAT(log_call_capturer.calls(), ElementsAre(
+      std::string("signed=0 unsigned=0"),
+      std::string("signed=-2147483648 unsigned=4294967295")));
+}
+
 TEST(wasmdemo, add) {
   EXPECT_EQ(add(0, 0), 0);
   EXPECT_EQ(add(0, 1), 1);
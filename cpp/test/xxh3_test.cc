@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "wasmdemo/xxh3.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct KnownAnswer {
+  size_t length;
+  uint64_t low64;
+  uint64_t high64;
+};
+
+// XXH3_128bits() of the first `length` bytes of testInput(), as computed by the
+// reference xxHash 0.8 implementation. The lengths cover every code path: the
+// 0, 1-3, 4-8, 9-16, 17-128 and 129-240 byte special cases, and the long input
+// loop with one or more full stripes and blocks.
+const KnownAnswer KNOWN_ANSWERS[] = {
+  {0, 0x6001c324468d497f, 0x99aa06d3014798d8},
+  {1, 0xf319fe2bdfcdfebd, 0xf46d8182f5a4994a},
+  {3, 0xa107bb65b715c89b, 0xd3d72a54a914da93},
+  {4, 0xb7a8c115066c18e7, 0xc867fd251db3e6d7},
+  {8, 0x60bc8bccebcb0734, 0xc1dcf76c2349c002},
+  {9, 0xb9c86cb7bbd227e1, 0x24715b781c227b4a},
+  {16, 0x07c505a161cba698, 0x4715746bc21d17e7},
+  {17, 0x5ddb4bdb41c4d361, 0xa61962a667ca7ed6},
+  {64, 0x5c4d64a21ef984fb, 0xe8b10cbf2525c577},
+  {128, 0x7c51fe50e15f6096, 0xaae9a17eb929dc9d},
+  {129, 0x3719d4b5edf9698c, 0x877435aab16492ae},
+  {240, 0xd00971547fa0f047, 0xcac9eb58c47b4547},
+  {241, 0x55d48f1a1bf9297a, 0x144500c4bc51523b},
+  {1000, 0x85a6494c77635c46, 0x3649344487fd1868},
+  {5000, 0x6cdea1ff4e90762c, 0xb9930a5fe8d8ecc7},
+};
+
+std::vector<uint8_t> testInput() {
+  std::vector<uint8_t> input(5000);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = static_cast<uint8_t>((i * 131 + 17) ^ (i >> 3));
+  }
+  return input;
+}
+
+TEST(wasmdemo, xxh3Hash128_ShouldMatchReferenceImplementation) {
+  const std::vector<uint8_t> input = testInput();
+  for (const KnownAnswer& knownAnswer : KNOWN_ANSWERS) {
+    const Xxh3Hash128 hash = xxh3Hash128(input.data(), knownAnswer.length);
+    EXPECT_EQ(hash.low64, knownAnswer.low64) << "length=" << knownAnswer.length;
+    EXPECT_EQ(hash.high64, knownAnswer.high64) << "length=" << knownAnswer.length;
+  }
+}
+
+TEST(wasmdemo, xxh3Hash128_ShouldNotDependOnAlignment) {
+  const std::vector<uint8_t> input = testInput();
+  for (size_t length : {7u, 15u, 100u, 200u, 1000u}) {
+    std::vector<uint8_t> shifted(length + 8);
+    for (size_t offset = 1; offset < 8; offset++) {
+      std::copy(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(length), shifted.begin() + static_cast<std::ptrdiff_t>(offset));
+      const Xxh3Hash128 expected = xxh3Hash128(input.data(), length);
+      const Xxh3Hash128 actual = xxh3Hash128(shifted.data() + offset, length);
+      EXPECT_EQ(actual.low64, expected.low64) << "length=" << length << " offset=" << offset;
+      EXPECT_EQ(actual.high64, expected.high64) << "length=" << length << " offset=" << offset;
+    }
+  }
+}
+
+} // namespace
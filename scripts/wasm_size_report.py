@@ -0,0 +1,107 @@
+import argparse
+import dataclasses
+import pathlib
+import sys
+
+
+SECTION_NAMES = {
+  0: "custom",
+  1: "type",
+  2: "import",
+  3: "function",
+  4: "table",
+  5: "memory",
+  6: "global",
+  7: "export",
+  8: "start",
+  9: "element",
+  10: "code",
+  11: "data",
+  12: "datacount",
+  13: "tag",
+}
+
+
+def main():
+  arg_parser = argparse.ArgumentParser(
+    description="Prints the size of each section of a WebAssembly binary, "
+      "and fails if the binary is larger than a budget."
+  )
+  arg_parser.add_argument("wasm_file")
+  arg_parser.add_argument("--max-size", type=int, default=0,
+    help="The largest allowed size of the binary, in bytes; 0 for no limit")
+  arg_parser.add_argument("--output",
+    help="A file to write the report to, only if the binary is within budget")
+  parsed_args = arg_parser.parse_args()
+
+  wasm_file = pathlib.Path(parsed_args.wasm_file)
+  max_size = parsed_args.max_size
+  output_file = pathlib.Path(parsed_args.output) if parsed_args.output else None
+  del arg_parser, parsed_args
+
+  wasm = wasm_file.read_bytes()
+  sections = parse_sections(wasm)
+  report = format_report(wasm_file, len(wasm), max_size, sections)
+  print(report, end="")
+
+  if max_size > 0 and len(wasm) > max_size:
+    print(f"ERROR: {wasm_file.name} is {len(wasm)} bytes, "
+      f"{len(wasm) - max_size} bytes over its budget of {max_size} bytes",
+      file=sys.stderr)
+    sys.exit(1)
+
+  if output_file is not None:
+    output_file.write_text(report, encoding="utf8")
+
+
+@dataclasses.dataclass(frozen=True)
+class Section:
+  name: str
+  size: int
+
+
+def parse_sections(wasm):
+  if wasm[:4] != b"\0asm":
+    raise ValueError("not a WebAssembly binary")
+
+  sections = []
+  pos = 8
+  while pos < len(wasm):
+    start = pos
+    section_id = wasm[pos]
+    content_size, pos = read_leb128(wasm, pos + 1)
+    name = SECTION_NAMES.get(section_id, f"unknown({section_id})")
+    if section_id == 0:
+      name_length, name_pos = read_leb128(wasm, pos)
+      custom_name = wasm[name_pos:name_pos + name_length].decode("utf8", "replace")
+      name = f"custom \"{custom_name}\""
+    pos += content_size
+    sections.append(Section(name=name, size=pos - start))
+  return tuple(sections)
+
+
+def read_leb128(data, pos):
+  value = 0
+  shift = 0
+  while True:
+    byte = data[pos]
+    pos += 1
+    value |= (byte & 0x7f) << shift
+    shift += 7
+    if byte & 0x80 == 0:
+      return value, pos
+
+
+def format_report(wasm_file, size, max_size, sections):
+  lines = [f"{wasm_file.name}: {size} bytes"]
+  if max_size > 0:
+    lines[0] += f" ({size * 100 / max_size:.1f}% of the {max_size} byte budget)"
+  name_width = max((len(section.name) for section in sections), default=0)
+  for section in sections:
+    lines.append(f"  {section.name:<{name_width}} {section.size:>9} bytes "
+      f"{section.size * 100 / size:5.1f}%")
+  return "\n".join(lines) + "\n"
+
+
+if __name__ == "__main__":
+  main()
@@ -26,8 +26,15 @@ set(CMAKE_C_COMPILER "${WASM32_CLANG_ROOT}/bin/clang")
 set(CMAKE_CXX_COMPILER "${WASM32_CLANG_ROOT}/bin/clang++")
 set(CMAKE_AR "${WASM32_CLANG_ROOT}/bin/llvm-ar")
 set(CMAKE_RANLIB "${WASM32_CLANG_ROOT}/bin/llvm-ranlib")
-set(CMAKE_C_COMPILER_TARGET wasm32-wasi)
-set(CMAKE_CXX_COMPILER_TARGET wasm32-wasi)
+# WASMDEMO_THREADS (see CMakeLists.txt) selects the wasi-threads target, whose
+# libc has pthreads, and so std::thread, on top of a shared memory.
+if(WASMDEMO_THREADS)
+  set(CMAKE_C_COMPILER_TARGET wasm32-wasi-threads)
+  set(CMAKE_CXX_COMPILER_TARGET wasm32-wasi-threads)
+else()
+  set(CMAKE_C_COMPILER_TARGET wasm32-wasi)
+  set(CMAKE_CXX_COMPILER_TARGET wasm32-wasi)
+endif()
 
 # Don't look in the sysroot for executables to run during the build
 set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
@@ -54,4 +61,13 @@ if(NOT DEFINED WASMDEMO_WASMTIME_EXECUTABLE)
   endif()
 endif()
 
-set(CMAKE_CROSSCOMPILING_EMULATOR "${WASMDEMO_WASMTIME_EXECUTABLE}")
+# A shared memory must be declared with a maximum size; 1 GiB by default.
+if(NOT DEFINED WASMDEMO_WASM32_MAX_MEMORY)
+  set(WASMDEMO_WASM32_MAX_MEMORY 1073741824)
+endif()
+
+if(WASMDEMO_THREADS)
+  set(CMAKE_CROSSCOMPILING_EMULATOR "${WASMDEMO_WASMTIME_EXECUTABLE};-W;threads=y;-S;threads=y")
+else()
+  set(CMAKE_CROSSCOMPILING_EMULATOR "${WASMDEMO_WASMTIME_EXECUTABLE}")
+endif()
@@ -24,10 +24,17 @@ def main():
 
   date_text = datetime.datetime.now().strftime("%c")
 
+  if len(mjs_exports) > 0:
+    script_url = "import.meta.url"
+  else:
+    script_url = "document.currentScript.src"
+
   src = src_file.read_text("utf8")
   src_modified = (
     src
     .replace("REPLACE_WITH_BASE64", wasm_base64)
+    .replace("REPLACE_WITH_WASM_FILE_NAME", wasm_file.name)
+    .replace("REPLACE_WITH_SCRIPT_URL", script_url)
     .replace("REPLACE_WITH_DATE", date_text)
     .replace("REPLACE_WITH_SIZE_RAW", f"{wasm_num_bytes} bytes")
     .replace("REPLACE_WITH_SIZE_BASE64", f"{wasm_base64_num_bytes} bytes")
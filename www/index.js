@@ -1,6 +1,13 @@
 "use strict";
 
 const WASM_BASE64 = "REPLACE_WITH_BASE64";
+// The name of the copy of the module that is generated next to this script.
+// Browsers compile it while it downloads, instead of decoding WASM_BASE64.
+const WASM_FILE_NAME = "REPLACE_WITH_WASM_FILE_NAME";
+// The URL of this script, which WASM_FILE_NAME is relative to (rather than to
+// the page, which may be anywhere else): import.meta.url in index.mjs, and the
+// src of the <script> element otherwise.
+const SCRIPT_URL = REPLACE_WITH_SCRIPT_URL;
 const logElement = document.getElementById("pLogs");
 const num1Element = document.getElementById("txtNum1");
 const num2Element = document.getElementById("txtNum2");
@@ -13,6 +20,38 @@ const ERRNO_EACCES = 2;
 const INT32_MIN = -2147483648;
 const INT32_MAX = 2147483647;
 
+// The number of released instances that are kept for reuse.
+const MAX_POOLED_INSTANCES = 4;
+
+// The ids of the BloomFilter::IndexMapping and KeyHash values (see
+// cpp/include/common/wasmdemo/bloom.h) for the `options` of the filter
+// functions. The defaults, MODULO and MD5, are the Firestore ones; the others
+// are faster, but only for filters whose format we own.
+const INDEX_MAPPING = Object.freeze({MODULO: 0, MULTIPLY_SHIFT: 1});
+const KEY_HASH = Object.freeze({MD5: 0, XXH3_128: 1});
+
+// The uint64_t counters of WasmdemoStats (see
+// cpp/include/common/wasmdemo/stats.h), in order, for WASMDEMO_STATS_VERSION 1.
+const STATS_VERSION = 1;
+const STATS_COUNTER_NAMES = Object.freeze([
+  "bloomFiltersCreated",
+  "bloomCreateNanos",
+  "bloomProbes",
+  "bloomPositives",
+  "bloomNegativeProbeDepths",
+  "bloomBatchProbeNanos",
+  "md5Blocks",
+  "base64DecodedBytes",
+  "base64DecodeNanos",
+  "allocations",
+  "allocatedBytes",
+]);
+const STATS_PROBE_DEPTH_BUCKET_COUNT = 16;
+
+// The size of the blocks of the arena that holds the strings and buffers that
+// are passed to a single call into the module.
+const SCRATCH_ARENA_BLOCK_SIZE = 64 * 1024;
+
 const WASI_IMPORTS = Object.freeze({
   wasi_snapshot_preview1: {
     fd_close: function(fd) {
@@ -45,10 +84,6 @@ function WasmString(instance, ptr, size) {
   this.ptr = ptr;
   this.size = size;
 
-  this.free = function() {
-    instance.exports.free(ptr);
-  }
-
   this.newUint8Array = function() {
     return new Uint8Array(instance.exports.memory.buffer, ptr, size);
   }
@@ -60,6 +95,8 @@ function WasmString(instance, ptr, size) {
 }
 
 function MyWebAssemblyInstance(instance) {
+  const scratchArena = instance.exports.arenaCreate(SCRATCH_ARENA_BLOCK_SIZE);
+
   this.malloc = function(size) {
     if (! Number.isInteger(size)) {
       throw new Error(`invalid size: ${size}`);
@@ -73,15 +110,74 @@ function MyWebAssemblyInstance(instance) {
     instance.exports.free(ptr);
   }
 
-  this.echo = function(message) {
-    const wasmMessage = this.newWasmString(message);
+  // Passes the log lines that the module has buffered to the `log` import.
+  this.flushLog = function() {
+    instance.exports.flushLog();
+  }
+
+  // Drops the module's log messages below `level`: 0 for debug, 1 for info, 2
+  // for warning, 3 for error and 4 for none.
+  this.setLogLevel = function(level) {
+    if (! Number.isInteger(level) || level < 0 || level > 4) {
+      throw new Error(`invalid log level: ${level}`);
+    }
+    instance.exports.setLogLevel(level);
+  }
+
+  // Returns the module's counters as an object with a property per field of
+  // WasmdemoStats, and bloomNegativeProbeDepths as an array. They are all 0
+  // unless the module was built with WASMDEMO_STATS.
+  this.readStats = function() {
+    const ptr = instance.exports.readStats();
+    const header = new Uint32Array(instance.exports.memory.buffer, ptr, 2);
+    if (header[0] !== STATS_VERSION) {
+      throw new Error(`unsupported stats version: ${header[0]}`);
+    }
+    const counterCount = STATS_COUNTER_NAMES.length - 1 + STATS_PROBE_DEPTH_BUCKET_COUNT;
+    const counters = new BigUint64Array(instance.exports.memory.buffer, ptr + 8, counterCount);
+    const stats = { enabled: header[1] !== 0 };
+    let index = 0;
+    for (const name of STATS_COUNTER_NAMES) {
+      if (name === "bloomNegativeProbeDepths") {
+        stats[name] = Array.from(counters.subarray(index, index + STATS_PROBE_DEPTH_BUCKET_COUNT), Number);
+        index += STATS_PROBE_DEPTH_BUCKET_COUNT;
+      } else {
+        stats[name] = Number(counters[index++]);
+      }
+    }
+    return stats;
+  }
+
+  this.resetStats = function() {
+    instance.exports.resetStats();
+  }
+
+  // Calls `callback`, then frees everything that it allocated with
+  // scratchAlloc() or newScratchString() at once. Scratch memory is reused from
+  // call to call, so it costs no allocations once the arena has grown.
+  this.withScratch = function(callback) {
     try {
-      instance.exports.echo(wasmMessage.ptr, wasmMessage.size);
+      return callback();
     } finally {
-      wasmMessage.free();
+      instance.exports.arenaReset(scratchArena);
     }
   }
 
+  this.scratchAlloc = function(size) {
+    const ptr = instance.exports.arenaAlloc(scratchArena, size);
+    if (ptr === 0) {
+      throw new Error(`out of memory allocating ${size} bytes`);
+    }
+    return ptr;
+  }
+
+  this.echo = function(message) {
+    this.withScratch(() => {
+      const wasmMessage = this.newScratchString(message);
+      instance.exports.echo(wasmMessage.ptr, wasmMessage.size);
+    });
+  }
+
   this.echo_signed_unsigned = function(num) {
     if (! Number.isInteger(num)) {
       throw new Error(`invalid num: ${num}`);
@@ -100,79 +196,249 @@ function MyWebAssemblyInstance(instance) {
   }
 
   this.reverse = function(s) {
-    const wasmString = this.newWasmString(s);
-    try {
+    return this.withScratch(() => {
+      const wasmString = this.newScratchString(s);
       instance.exports.reverse_string(wasmString.ptr, wasmString.size);
       return wasmString.toString();
-    } finally {
-      wasmString.free();
-    }
+    });
   }
 
   this.hash = function(s) {
-    const wasmString = this.newWasmString(s);
-    let outputBufPtr;
-    try {
-      outputBufPtr = instance.exports.hash(wasmString.ptr, wasmString.size);
-    } finally {
-      wasmString.free();
-    }
-    return new Uint8Array(instance.exports.memory.buffer, outputBufPtr, 16);
+    return this.hashMulti([s])[0];
+  }
+
+  // Returns the MD5 digests of all of the given values, computed with a single
+  // call into the WebAssembly module, as one 16-byte Uint8Array per value.
+  this.hashMulti = function(values) {
+    const {memory, hashMulti} = instance.exports;
+    const textEncoder = new TextEncoder("utf8");
+    const encodedValues = values.map(value => textEncoder.encode(`${value}`));
+    const dataSize = encodedValues.reduce((size, value) => size + value.length, 0);
+
+    return this.withScratch(() => {
+      const dataPtr = this.scratchAlloc(dataSize);
+      const offsetsPtr = this.scratchAlloc((values.length + 1) * 4);
+      const resultsPtr = this.scratchAlloc(values.length * 16);
+      const data = new Uint8Array(memory.buffer, dataPtr, dataSize);
+      const offsets = new Int32Array(memory.buffer, offsetsPtr, values.length + 1);
+      let offset = 0;
+      encodedValues.forEach((value, i) => {
+        offsets[i] = offset;
+        data.set(value, offset);
+        offset += value.length;
+      });
+      offsets[values.length] = offset;
+
+      hashMulti(dataPtr, offsetsPtr, values.length, resultsPtr);
+
+      // Copy the digests out of the scratch memory before it is reused.
+      const results = new Uint8Array(memory.buffer, resultsPtr, values.length * 16).slice();
+      return values.map((_, i) => results.subarray(i * 16, i * 16 + 16));
+    });
   }
 
-  this.newBloomFilter = function(bitmap, padding, hashCount) {
-    const {memory, newBloomFilter} = instance.exports;
-    const bufPtr = this.malloc(bitmap.length);
+  // Copies the bitmap into linear memory once and hands that buffer over to the
+  // filter, which frees it in deleteBloomFilter(). `options` may set the
+  // filter's `indexMapping` (an INDEX_MAPPING value) and `keyHash` (a KEY_HASH
+  // value).
+  this.newBloomFilter = function(bitmap, padding, hashCount, options = {}) {
+    const {memory, allocBloomFilterBitmap, newBloomFilterAdoptingBitmapWithOptions} = instance.exports;
+    const bufPtr = allocBloomFilterBitmap(bitmap.length);
+    if (bufPtr === 0) {
+      throw new Error(`out of memory allocating a ${bitmap.length} byte bitmap`);
+    }
     const inputBuf = new Uint8Array(memory.buffer, bufPtr, bitmap.length);
     inputBuf.set(bitmap);
-    const filterPtr = newBloomFilter(bufPtr, bitmap.length, padding, hashCount);
-    this.free(bufPtr);
+    const {indexMapping = INDEX_MAPPING.MODULO, keyHash = KEY_HASH.MD5} = options;
+    return newBloomFilterAdoptingBitmapWithOptions(bufPtr, bitmap.length, padding, hashCount, indexMapping, keyHash);
+  }
+
+  // Creates a filter from a base64-encoded bitmap, which is decoded directly
+  // into the filter's bitmap by the WebAssembly module. `options` may set the
+  // filter's `indexMapping` and `keyHash`, as in newBloomFilter().
+  this.newBloomFilterFromBase64 = function(base64Bitmap, padding, hashCount, options = {}) {
+    const {indexMapping = INDEX_MAPPING.MODULO, keyHash = KEY_HASH.MD5} = options;
+    const filterPtr = this.withScratch(() => {
+      const wasmString = this.newScratchString(base64Bitmap);
+      return instance.exports.newBloomFilterFromBase64WithOptions(
+        wasmString.ptr, wasmString.size, padding, hashCount, indexMapping, keyHash);
+    });
+    if (filterPtr === 0) {
+      throw new Error(`out of memory decoding a ${base64Bitmap.length} character bitmap`);
+    }
     return filterPtr;
   }
 
   this.mightContain = function(filterPointer, s) {
-    const wasmString = this.newWasmString(s);
-    let result;
-    try {
-      result = instance.exports.mightContain(filterPointer, wasmString.ptr, wasmString.size);
-    } finally {
-      wasmString.free();
-    }
+    return this.withScratch(() => {
+      const wasmString = this.newScratchString(s);
+      return instance.exports.mightContain(filterPointer, wasmString.ptr, wasmString.size);
+    });
+  }
+
+  // Tests all of the given values against the filter with a single call into
+  // the WebAssembly module, returning an array with one boolean per value.
+  this.mightContainBatch = function(filterPointer, values) {
+    const {memory, mightContainBatch} = instance.exports;
+    const textEncoder = new TextEncoder("utf8");
+    const encodedValues = values.map(value => textEncoder.encode(`${value}`));
+    const keysSize = encodedValues.reduce((size, value) => size + value.length, 0);
+    const resultsSize = Math.ceil(values.length / 8);
+
+    return this.withScratch(() => {
+      const keysPtr = this.scratchAlloc(keysSize);
+      const offsetsPtr = this.scratchAlloc((values.length + 1) * 4);
+      const resultsPtr = this.scratchAlloc(resultsSize);
+      const keys = new Uint8Array(memory.buffer, keysPtr, keysSize);
+      const offsets = new Int32Array(memory.buffer, offsetsPtr, values.length + 1);
+      let offset = 0;
+      encodedValues.forEach((value, i) => {
+        offsets[i] = offset;
+        keys.set(value, offset);
+        offset += value.length;
+      });
+      offsets[values.length] = offset;
+
+      mightContainBatch(filterPointer, keysPtr, offsetsPtr, values.length, resultsPtr);
+
+      const results = new Uint8Array(memory.buffer, resultsPtr, resultsSize);
+      return values.map((_, i) => (results[i >> 3] & (1 << (i & 7))) !== 0);
+    });
+  }
 
-    return result;
+  // Hashes a prefix that many keys share, e.g. the path of a collection's
+  // documents, once; the returned pointer is passed to mightContainWithPrefix()
+  // and must be released with deleteKeyPrefix().
+  this.newKeyPrefix = function(prefix) {
+    return this.withScratch(() => {
+      const wasmString = this.newScratchString(prefix);
+      return instance.exports.newKeyPrefix(wasmString.ptr, wasmString.size);
+    });
+  }
+
+  this.deleteKeyPrefix = function(prefixPointer) {
+    instance.exports.deleteKeyPrefix(prefixPointer);
+  }
+
+  // Tests the key that is the given prefix followed by `suffix`, hashing only
+  // the suffix.
+  this.mightContainWithPrefix = function(filterPointer, prefixPointer, suffix) {
+    return this.withScratch(() => {
+      const wasmString = this.newScratchString(suffix);
+      return instance.exports.mightContainWithPrefix(
+        filterPointer, prefixPointer, wasmString.ptr, wasmString.size);
+    });
   }
 
   this.deleteBloomFilter = function(filterPointer) {
     instance.exports.deleteBloomFilter(filterPointer);
   }
 
-  this.newWasmString = function(value) {
+  // Copies the string into scratch memory as UTF-8; see withScratch().
+  this.newScratchString = function(value) {
     const valueStr = `${value}`;
-    const mallocSize = valueStr.length * 4;
-    const ptr = this.malloc(mallocSize);
-    const uint8Array = new Uint8Array(instance.exports.memory.buffer, ptr, mallocSize);
+    const allocSize = valueStr.length * 4;
+    const ptr = this.scratchAlloc(allocSize);
+    const uint8Array = new Uint8Array(instance.exports.memory.buffer, ptr, allocSize);
     const { written: numBytes } = new TextEncoder("utf8").encodeInto(valueStr, uint8Array);
     return new WasmString(instance, ptr, numBytes);
   }
 }
 
-async function loadWebAssemblyModule() {
-  const wasm = Uint8Array.from(atob(WASM_BASE64), v => v.charCodeAt(0));
-  const instances = []
-  const { instance } = await WebAssembly.instantiate(wasm, {
+// The compiled module, which every instance shares, once compilation started.
+let webAssemblyModulePromise = null;
+
+// Instances that were released with releaseWebAssemblyInstance().
+const webAssemblyInstancePool = [];
+
+// Compiles the module on the first call, and returns the same compiled module
+// from then on. Calling it early, e.g. while the page loads, takes the
+// compilation out of the first loadWebAssemblyModule() call.
+function compileWebAssemblyModule() {
+  if (webAssemblyModulePromise === null) {
+    webAssemblyModulePromise = compileWebAssemblyModuleUncached();
+    // Let a later call try again, rather than failing forever.
+    webAssemblyModulePromise.catch(() => {
+      webAssemblyModulePromise = null;
+    });
+  }
+  return webAssemblyModulePromise;
+}
+
+async function compileWebAssemblyModuleUncached() {
+  // Pages that are opened from the file system can't fetch the sidecar file.
+  const canFetch = typeof fetch === "function"
+    && typeof WebAssembly.compileStreaming === "function"
+    && typeof location !== "undefined"
+    && location.protocol !== "file:";
+  if (canFetch) {
+    try {
+      return await WebAssembly.compileStreaming(fetch(new URL(WASM_FILE_NAME, SCRIPT_URL)));
+    } catch (e) {
+      // e.g. the file is missing, or is not served as application/wasm.
+      console.log(`Compiling ${WASM_FILE_NAME} failed, using the embedded module: ${e}`);
+    }
+  }
+  return await WebAssembly.compile(decodeBase64(WASM_BASE64));
+}
+
+function decodeBase64(base64) {
+  if (typeof Uint8Array.fromBase64 === "function") {
+    return Uint8Array.fromBase64(base64);
+  }
+  const binary = atob(base64);
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; i++) {
+    bytes[i] = binary.charCodeAt(i);
+  }
+  return bytes;
+}
+
+// Decodes the text that the module passes to the `log` import.
+const LOG_TEXT_DECODER = new TextDecoder("utf8");
+
+async function instantiateWebAssemblyModule(module) {
+  let instance;
+  instance = await WebAssembly.instantiate(module, {
     base: {
+      // Called with one message, or with a batch of the module's buffered log
+      // lines (see flushLog()), which each end with "\n".
       log: function(ptr, size) {
-        const uint8Array = new Uint8Array(instances[0].exports.memory.buffer, ptr, size);
-        const message = new TextDecoder("utf8").decode(uint8Array);
-        log(`log(): ${message} (ptr=${ptr} size=${size})`);
+        const uint8Array = new Uint8Array(instance.exports.memory.buffer, ptr, size);
+        const text = LOG_TEXT_DECODER.decode(uint8Array);
+        for (const line of text.split("\n")) {
+          if (line.length > 0) {
+            log(`log(): ${line}`);
+          }
+        }
       }
     },
     ...WASI_IMPORTS
   });
-  instances.push(instance);
   return new MyWebAssemblyInstance(instance);
 }
 
+// Returns an instance of the module: a released one if there is any, or else
+// a new instance of the compiled module, which only needs its own memory.
+async function loadWebAssemblyModule() {
+  const pooledInstance = webAssemblyInstancePool.pop();
+  if (pooledInstance !== undefined) {
+    return pooledInstance;
+  }
+  return instantiateWebAssemblyModule(await compileWebAssemblyModule());
+}
+
+// Hands an instance from loadWebAssemblyModule() back, for a later call to
+// reuse, after passing on the log lines that it buffered. The caller must have
+// deleted everything that it created in the instance, and must not use it
+// anymore.
+function releaseWebAssemblyInstance(webAssemblyInstance) {
+  webAssemblyInstance.flushLog();
+  if (webAssemblyInstancePool.length < MAX_POOLED_INSTANCES) {
+    webAssemblyInstancePool.push(webAssemblyInstance);
+  }
+}
+
 async function onHashTestWasmClick() {
   log("Hash Test Started");
   try {
@@ -192,6 +458,7 @@ async function onHashTestWasmClick() {
 
     log(`Hashed ${numHashes} strings with WebAssembly MD5 algorithm ` +
       `in ${accumulatedMs.toFixed(3)} ms`);
+    releaseWebAssemblyInstance(webAssemblyInstance);
   } catch (e) {
     log(`ERROR: ${e}`);
     console.log(e.stack);
@@ -230,6 +497,7 @@ async function onRunClick() {
     log(`malloc(8192) returned ${mallocResult}`);
     log(`Calling free(${mallocResult})`);
     webAssemblyInstance.free(mallocResult);
+    releaseWebAssemblyInstance(webAssemblyInstance);
   } catch (e) {
     log(`ERROR: ${e}`);
     console.log(e.stack);
@@ -278,4 +546,7 @@ function initializeWasmDemoUI() {
   document.getElementById("btnClear").onclick = onClearClick;
 
   initializeInputElementValues();
+
+  // Compile the module while the page is idle, rather than on the first click.
+  compileWebAssemblyModule().catch(e => log(`ERROR: ${e}`));
 }